@@ -0,0 +1,40 @@
+#include "Autopilot.h"
+
+#include <cmath>
+
+void applyKeys(Game& game, const std::string& keys) {
+    game.keyW = game.keyS = game.keyA = game.keyD = game.keySpace = false;
+    for (char c : keys) {
+        switch (c) {
+        case 'w': case 'W': game.keyW = true; break;
+        case 's': case 'S': game.keyS = true; break;
+        case 'a': case 'A': game.keyA = true; break;
+        case 'd': case 'D': game.keyD = true; break;
+        case 'j': case 'J': game.keySpace = true; break;
+        }
+    }
+}
+
+void randomInput(Game& game, std::mt19937& rng) {
+    static const char* choices[] = { "D", "S", "D", "S", "W", "A", "DJ", "SJ", "-" };
+    applyKeys(game, choices[rng() % 9]);
+}
+
+void botInput(Game& game, std::mt19937& rng) {
+    game.keyW = game.keyS = game.keyA = game.keyD = game.keySpace = false;
+    if (game.isRolling || game.isJumping) return;
+
+    int px = static_cast<int>(std::round(game.playerX));
+    int pz = static_cast<int>(std::round(game.playerZ));
+    bool alongX = game.onPath(px + 1.0f, static_cast<float>(pz));
+    bool alongZ = game.onPath(static_cast<float>(px), pz + 1.0f);
+    if (alongX && alongZ) {
+        alongZ = rng() % 2;
+        alongX = !alongZ;
+    }
+    bool blocked = alongX ? game.hasObstacle(px + 1, pz) : game.hasObstacle(px, pz + 1);
+
+    game.keyD = !alongZ;
+    game.keyS = alongZ;
+    game.keySpace = blocked;
+}
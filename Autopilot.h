@@ -0,0 +1,18 @@
+#pragma once
+
+#include <random>
+#include <string>
+
+#include "Game.h"
+
+// Input policies for driving a Game without a keyboard. Each one sets the
+// key flags for the next updateGame() call.
+
+// Holds exactly the given keys: any of W A S D, and J for jump (space)
+void applyKeys(Game& game, const std::string& keys);
+
+// Uniformly random keys, biased towards the directions the path grows in (+x, +z)
+void randomInput(Game& game, std::mt19937& rng);
+
+// Follows the path one tile at a time and jumps over any obstacle in the way
+void botInput(Game& game, std::mt19937& rng);
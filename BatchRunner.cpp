@@ -0,0 +1,121 @@
+#include "BatchRunner.h"
+
+#include <algorithm>
+#include <random>
+
+#include "Autopilot.h"
+#include "ThreadPool.h"
+
+void BatchStats::addGame(const Game& game, long gameTicks, bool timedOut) {
+    ++games;
+    ticks += gameTicks;
+    if (static_cast<size_t>(game.score) >= scoreCounts.size()) {
+        scoreCounts.resize(game.score + 1);
+    }
+    ++scoreCounts[game.score];
+
+    if (timedOut) {
+        ++timeouts;
+        return;
+    }
+    switch (game.deathCause) {
+    case Game::FELL_OFF: ++fellOff; break;
+    case Game::HIT_OBSTACLE: ++hitBy[game.killedBy]; break;
+    case Game::SIM_ERROR: ++errors; break;
+    default: break;
+    }
+}
+
+void BatchStats::merge(const BatchStats& other) {
+    games += other.games;
+    ticks += other.ticks;
+    if (other.scoreCounts.size() > scoreCounts.size()) {
+        scoreCounts.resize(other.scoreCounts.size());
+    }
+    for (size_t s = 0; s < other.scoreCounts.size(); ++s) {
+        scoreCounts[s] += other.scoreCounts[s];
+    }
+    fellOff += other.fellOff;
+    for (size_t t = 0; t <= ObstacleTypes::COUNT; ++t) {
+        hitBy[t] += other.hitBy[t];
+    }
+    timeouts += other.timeouts;
+    errors += other.errors;
+}
+
+double BatchStats::meanScore() const {
+    if (games == 0) return 0.0;
+    double sum = 0.0;
+    for (size_t s = 0; s < scoreCounts.size(); ++s) {
+        sum += static_cast<double>(s) * scoreCounts[s];
+    }
+    return sum / games;
+}
+
+int BatchStats::scorePercentile(double p) const {
+    long rank = static_cast<long>(p * (games - 1));
+    long seen = 0;
+    for (size_t s = 0; s < scoreCounts.size(); ++s) {
+        seen += scoreCounts[s];
+        if (seen > rank) return static_cast<int>(s);
+    }
+    return 0;
+}
+
+int BatchStats::maxScore() const {
+    return scoreCounts.empty() ? 0 : static_cast<int>(scoreCounts.size() - 1);
+}
+
+// Plays games [first, last) of one parameter set on a single Game instance
+static BatchStats runGames(const Game::Tuning& tuning, const BatchConfig& config, long first, long last) {
+    BatchStats stats;
+    Game game;
+    game.tuning = tuning;
+
+    for (long i = first; i < last; ++i) {
+        uint64_t seed = config.baseSeed + i;
+        game.reset(seed);
+        std::mt19937 inputRng(static_cast<uint32_t>(seed));
+
+        long tick = 0;
+        while (!game.gameOver && tick < config.maxTicksPerGame) {
+            botInput(game, inputRng);
+            game.updateGame(config.dt);
+            ++tick;
+        }
+        stats.addGame(game, tick, !game.gameOver);
+    }
+    return stats;
+}
+
+std::vector<BatchStats> runBatch(const std::vector<Game::Tuning>& parameterSets, const BatchConfig& config) {
+    long gamesPerTask = std::max(1L, config.gamesPerTask);
+    long tasksPerSet = (config.gamesPerSet + gamesPerTask - 1) / gamesPerTask;
+
+    // Each task writes only its own slot, so workers never share results
+    std::vector<BatchStats> partial(parameterSets.size() * tasksPerSet);
+    {
+        ThreadPool pool(config.threads);
+        for (size_t set = 0; set < parameterSets.size(); ++set) {
+            for (long task = 0; task < tasksPerSet; ++task) {
+                long first = task * gamesPerTask;
+                long last = std::min(config.gamesPerSet, first + gamesPerTask);
+                BatchStats* slot = &partial[set * tasksPerSet + task];
+                const Game::Tuning* tuning = &parameterSets[set];
+                pool.submit([slot, tuning, &config, first, last] {
+                    *slot = runGames(*tuning, config, first, last);
+                });
+            }
+        }
+        pool.wait();
+    }
+
+    std::vector<BatchStats> results(parameterSets.size());
+    for (size_t set = 0; set < parameterSets.size(); ++set) {
+        results[set].tuning = parameterSets[set];
+        for (long task = 0; task < tasksPerSet; ++task) {
+            results[set].merge(partial[set * tasksPerSet + task]);
+        }
+    }
+    return results;
+}
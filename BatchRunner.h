@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Game.h"
+
+// Runs many independent bot-driven games per parameter set on a ThreadPool
+// and aggregates how they ended. Game i of every set uses seed baseSeed + i,
+// so different parameter sets are compared on the same levels.
+struct BatchConfig {
+    long gamesPerSet = 10000;
+    float dt = 1.0f / 120.0f;
+    long maxTicksPerGame = 120 * 600; // Games still running after this count as timeouts
+    uint64_t baseSeed = 1;
+    unsigned threads = 0;             // 0 = one per hardware thread
+    long gamesPerTask = 64;
+};
+
+struct BatchStats {
+    Game::Tuning tuning;
+    long games = 0;
+    long long ticks = 0;
+    std::vector<long> scoreCounts;    // scoreCounts[s] = games that ended with score s
+    long fellOff = 0;
+    long hitBy[ObstacleTypes::COUNT + 1] = {}; // Indexed by Game::ObstacleType
+    long timeouts = 0;
+    long errors = 0;
+
+    void addGame(const Game& game, long gameTicks, bool timedOut);
+    void merge(const BatchStats& other);
+
+    double meanScore() const;
+    int scorePercentile(double p) const; // p in [0, 1]
+    int maxScore() const;
+};
+
+std::vector<BatchStats> runBatch(const std::vector<Game::Tuning>& parameterSets, const BatchConfig& config);
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Open-addressing hash map from a packed (x, z) grid cell to a 32-bit value.
+// Linear probing with backward-shift deletion, so there are no tombstones and
+// lookups stay O(1) however many insert/erase cycles the map goes through.
+class CellHash {
+public:
+    static constexpr uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    static uint64_t pack(int x, int z) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+    }
+
+    explicit CellHash(size_t initialCapacity = 64) {
+        size_t capacity = 16;
+        while (capacity < initialCapacity * 2) capacity <<= 1;
+        slots.assign(capacity, Slot{ 0, NOT_FOUND });
+        mask = capacity - 1;
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return slots.size(); }
+
+    void clear() {
+        for (auto& slot : slots) slot.value = NOT_FOUND;
+        count = 0;
+    }
+
+    // Inserts or overwrites the value stored for (x, z)
+    void insert(int x, int z, uint32_t value) {
+        if ((count + 1) * 2 > slots.size()) {
+            rehash(slots.size() * 2);
+        }
+
+        uint64_t key = pack(x, z);
+        size_t i = slotFor(key);
+        while (slots[i].value != NOT_FOUND) {
+            if (slots[i].key == key) {
+                slots[i].value = value;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        slots[i].key = key;
+        slots[i].value = value;
+        ++count;
+    }
+
+    // Returns the value stored for (x, z), or NOT_FOUND
+    uint32_t find(int x, int z) const {
+        uint64_t key = pack(x, z);
+        size_t i = slotFor(key);
+        while (slots[i].value != NOT_FOUND) {
+            if (slots[i].key == key) return slots[i].value;
+            i = (i + 1) & mask;
+        }
+        return NOT_FOUND;
+    }
+
+    bool contains(int x, int z) const { return find(x, z) != NOT_FOUND; }
+
+    bool erase(int x, int z) {
+        uint64_t key = pack(x, z);
+        size_t i = slotFor(key);
+        while (slots[i].value != NOT_FOUND) {
+            if (slots[i].key == key) {
+                removeAt(i);
+                return true;
+            }
+            i = (i + 1) & mask;
+        }
+        return false;
+    }
+
+    // Raw image for snapshots: capacity and count, then the slot array as it
+    // sits in memory, so restoring needs no rehashing. Returns nullptr if the
+    // image would run past end.
+    size_t imageBytes() const { return 2 * sizeof(uint64_t) + slots.size() * sizeof(Slot); }
+
+    uint8_t* saveImage(uint8_t* out) const {
+        uint64_t header[2] = { slots.size(), count };
+        std::memcpy(out, header, sizeof(header));
+        out += sizeof(header);
+        std::memcpy(out, slots.data(), slots.size() * sizeof(Slot));
+        return out + slots.size() * sizeof(Slot);
+    }
+
+    const uint8_t* loadImage(const uint8_t* in, const uint8_t* end) {
+        uint64_t header[2];
+        if (static_cast<size_t>(end - in) < sizeof(header)) return nullptr;
+        std::memcpy(header, in, sizeof(header));
+        in += sizeof(header);
+        size_t n = static_cast<size_t>(header[0]);
+        if (n == 0 || (n & (n - 1)) != 0 || header[1] >= n || static_cast<size_t>(end - in) / sizeof(Slot) < n) {
+            return nullptr;
+        }
+        slots.resize(n);
+        mask = n - 1;
+        count = static_cast<size_t>(header[1]);
+        std::memcpy(slots.data(), in, n * sizeof(Slot));
+        return in + n * sizeof(Slot);
+    }
+
+private:
+    struct Slot {
+        uint64_t key;
+        uint32_t value;
+    };
+
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    size_t count = 0;
+
+    size_t slotFor(uint64_t key) const {
+        // Fibonacci hashing spreads neighbouring cells across the table
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the hole
+    void removeAt(size_t hole) {
+        size_t i = hole;
+        while (true) {
+            i = (i + 1) & mask;
+            if (slots[i].value == NOT_FOUND) break;
+
+            size_t home = slotFor(slots[i].key);
+            // Move the entry back only if its home slot is not between hole and i
+            bool between = (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i);
+            if (!between) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole].value = NOT_FOUND;
+        --count;
+    }
+
+    void rehash(size_t newCapacity) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(newCapacity, Slot{ 0, NOT_FOUND });
+        mask = newCapacity - 1;
+        count = 0;
+        for (const auto& slot : old) {
+            if (slot.value == NOT_FOUND) continue;
+            size_t i = slotFor(slot.key);
+            while (slots[i].value != NOT_FOUND) i = (i + 1) & mask;
+            slots[i] = slot;
+            ++count;
+        }
+    }
+};
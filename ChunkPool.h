@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Free-list pool of fixed-size chunks. Chunks are allocated in slabs the first
+// time the pool runs dry and handed back on release instead of being freed, so
+// a structure that keeps a bounded number of chunks alive stops touching the
+// heap once it has warmed up. Chunk needs a `Chunk* nextFree` member, which the
+// pool owns while the chunk is on the free list.
+template <typename Chunk>
+class ChunkPool {
+public:
+    static constexpr size_t SLAB_CHUNKS = 8;
+
+    ChunkPool() = default;
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    ChunkPool(ChunkPool&& other) noexcept
+        : slabs(std::move(other.slabs)),
+          freeList(std::exchange(other.freeList, nullptr)),
+          allocated(std::exchange(other.allocated, 0)) {}
+
+    ChunkPool& operator=(ChunkPool&& other) noexcept {
+        slabs = std::move(other.slabs);
+        freeList = std::exchange(other.freeList, nullptr);
+        allocated = std::exchange(other.allocated, 0);
+        return *this;
+    }
+
+    Chunk* acquire() {
+        if (!freeList) addSlab(SLAB_CHUNKS);
+        Chunk* chunk = freeList;
+        freeList = chunk->nextFree;
+        chunk->nextFree = nullptr;
+        return chunk;
+    }
+
+    void release(Chunk* chunk) {
+        chunk->nextFree = freeList;
+        freeList = chunk;
+    }
+
+    // Makes sure at least n chunks exist, so the first n acquires do not allocate
+    void reserve(size_t n) {
+        if (n > allocated) addSlab(n - allocated);
+    }
+
+    // Chunks ever allocated by this pool (live plus free)
+    size_t allocatedChunks() const { return allocated; }
+
+private:
+    std::vector<std::unique_ptr<Chunk[]>> slabs;
+    Chunk* freeList = nullptr;
+    size_t allocated = 0;
+
+    void addSlab(size_t n) {
+        slabs.emplace_back(new Chunk[n]);
+        Chunk* slab = slabs.back().get();
+        for (size_t i = n; i-- > 0;) release(&slab[i]);
+        allocated += n;
+    }
+};
+
+// Sequence-numbered FIFO window over pooled chunks of Chunk::SLOTS elements (a
+// power of two). Element seq lives at slot seq % SLOTS of chunk seq / SLOTS,
+// and a small ring table maps live chunk numbers to chunks. Appending into a
+// new chunk takes one from the pool and retiring the last element of a chunk
+// hands it back, so elements never move once written and a growing window only
+// copies chunk pointers. Chunks are value-initialized when they join the window,
+// so slots not written yet hold zeroes rather than whatever the pool last held.
+template <typename Chunk>
+class ChunkWindow {
+public:
+    static constexpr size_t SLOTS = Chunk::SLOTS;
+    static_assert(SLOTS > 0 && (SLOTS & (SLOTS - 1)) == 0, "chunk size must be a power of two");
+
+    explicit ChunkWindow(size_t initialCapacity = 0) {
+        // A window of n elements straddles at most n / SLOTS + 1 chunks
+        size_t chunks = initialCapacity / SLOTS + 1;
+        resizeTable(chunks);
+        pool.reserve(chunks);
+    }
+
+    ChunkWindow(const ChunkWindow& other) : ChunkWindow(other.chunkCount() * SLOTS) {
+        for (uint64_t c = other.firstChunk(); c < other.endChunk(); ++c) {
+            Chunk* chunk = pool.acquire();
+            *chunk = *other.table[c & other.tableMask];
+            chunk->nextFree = nullptr;
+            table[c & tableMask] = chunk;
+        }
+        head = other.head;
+        count = other.count;
+    }
+
+    ChunkWindow& operator=(const ChunkWindow& other) {
+        if (this != &other) {
+            ChunkWindow copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    ChunkWindow(ChunkWindow&& other) noexcept
+        : pool(std::move(other.pool)), table(std::move(other.table)), tableMask(other.tableMask),
+          head(other.head), count(other.count) {
+        other.forget();
+    }
+
+    ChunkWindow& operator=(ChunkWindow&& other) noexcept {
+        pool = std::move(other.pool);
+        table = std::move(other.table);
+        tableMask = other.tableMask;
+        head = other.head;
+        count = other.count;
+        other.forget();
+        return *this;
+    }
+
+    size_t size() const { return count; }
+    uint64_t frontSeq() const { return head; }
+    uint64_t endSeq() const { return head + count; }
+
+    // Elements the window can hold without allocating
+    size_t capacity() const { return pool.allocatedChunks() * SLOTS; }
+
+    // Chunks holding a window of count elements from head; an empty window keeps
+    // the chunk its next element goes into
+    static uint64_t chunksFor(uint64_t head, uint64_t count) {
+        return (head % SLOTS + count + SLOTS - 1) / SLOTS;
+    }
+    size_t chunkCount() const { return static_cast<size_t>(chunksFor(head, count)); }
+
+    Chunk* chunkAt(uint64_t seq) const { return table[(seq / SLOTS) & tableMask]; }
+    static size_t slotOf(uint64_t seq) { return static_cast<size_t>(seq & (SLOTS - 1)); }
+
+    // Appends one element and returns its sequence number; the caller fills its slot
+    uint64_t push() {
+        uint64_t seq = head + count;
+        if (slotOf(seq) == 0) attachChunk(seq / SLOTS);
+        ++count;
+        return seq;
+    }
+
+    void pop() {
+        ++head;
+        --count;
+        if (slotOf(head) == 0) detachChunk(head / SLOTS - 1);
+    }
+
+    // Appends n elements at once (as n calls to push)
+    void extend(size_t n) {
+        while (n > 0) {
+            uint64_t seq = head + count;
+            if (slotOf(seq) == 0) attachChunk(seq / SLOTS);
+            size_t added = std::min(n, SLOTS - slotOf(seq));
+            count += added;
+            n -= added;
+        }
+    }
+
+    // Empties the window so the next element pushed gets sequence number seq
+    void resetTo(uint64_t seq) {
+        for (uint64_t c = firstChunk(); c < endChunk(); ++c) detachChunk(c);
+        head = seq & ~uint64_t(SLOTS - 1);
+        count = 0;
+        if (slotOf(seq) != 0) attachChunk(seq / SLOTS);
+        head = seq;
+    }
+
+    // Calls f(chunk) for each chunk held by the window, front to back
+    template <typename F>
+    void forEachChunk(F&& f) const {
+        for (uint64_t c = firstChunk(); c < endChunk(); ++c) f(table[c & tableMask]);
+    }
+
+private:
+    ChunkPool<Chunk> pool;
+    std::vector<Chunk*> table;
+    size_t tableMask = 0;
+    uint64_t head = 0;
+    size_t count = 0;
+
+    uint64_t firstChunk() const { return head / SLOTS; }
+    uint64_t endChunk() const { return firstChunk() + chunksFor(head, count); }
+
+    void attachChunk(uint64_t c) {
+        if (chunkCount() == table.size()) resizeTable(table.size() * 2);
+        Chunk* chunk = pool.acquire();
+        *chunk = Chunk();
+        table[c & tableMask] = chunk;
+    }
+
+    void detachChunk(uint64_t c) {
+        pool.release(table[c & tableMask]);
+        table[c & tableMask] = nullptr;
+    }
+
+    void resizeTable(size_t minSize) {
+        size_t n = 1;
+        while (n < minSize) n <<= 1;
+        std::vector<Chunk*> bigger(n, nullptr);
+        for (uint64_t c = firstChunk(); c < endChunk(); ++c) bigger[c & (n - 1)] = table[c & tableMask];
+        table.swap(bigger);
+        tableMask = n - 1;
+    }
+
+    void forget() {
+        table.clear();
+        tableMask = 0;
+        head = 0;
+        count = 0;
+    }
+};
@@ -0,0 +1,104 @@
+// Batch simulator for tuning difficulty: plays many bot-driven games for every
+// combination of the given parameter values across all cores, then prints the
+// score distribution and how the games ended for each combination.
+//
+// Usage: crossy_batch [--games N] [--threads N] [--dt SECONDS] [--max-ticks N]
+//                     [--seed N] [--lifetime A,B,...] [--spawn-chance A,B,...]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BatchRunner.h"
+#include "ThreadPool.h"
+
+static std::vector<float> parseList(const std::string& text) {
+    std::vector<float> values;
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        values.push_back(static_cast<float>(std::atof(item.c_str())));
+    }
+    if (values.empty()) {
+        throw std::runtime_error("empty value list: " + text);
+    }
+    return values;
+}
+
+int main(int argc, char** argv) {
+    try {
+        BatchConfig config;
+        std::vector<float> lifetimes = { Game::PLATFORM_LIFETIME };
+        std::vector<float> spawnChances = { Game::OBSTACLE_SPAWN_CHANCE };
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--games" && hasValue) config.gamesPerSet = std::atol(argv[++i]);
+            else if (arg == "--threads" && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--dt" && hasValue) config.dt = static_cast<float>(std::atof(argv[++i]));
+            else if (arg == "--max-ticks" && hasValue) config.maxTicksPerGame = std::atol(argv[++i]);
+            else if (arg == "--seed" && hasValue) config.baseSeed = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--lifetime" && hasValue) lifetimes = parseList(argv[++i]);
+            else if (arg == "--spawn-chance" && hasValue) spawnChances = parseList(argv[++i]);
+            else {
+                std::cerr << "Usage: crossy_batch [--games N] [--threads N] [--dt SECONDS] [--max-ticks N]\n"
+                    "                    [--seed N] [--lifetime A,B,...] [--spawn-chance A,B,...]" << std::endl;
+                return 1;
+            }
+        }
+
+        std::vector<Game::Tuning> parameterSets;
+        for (float lifetime : lifetimes) {
+            for (float spawnChance : spawnChances) {
+                Game::Tuning tuning;
+                tuning.platformLifetime = lifetime;
+                tuning.obstacleSpawnChance = spawnChance;
+                parameterSets.push_back(tuning);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<BatchStats> results = runBatch(parameterSets, config);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // One death-cause column per obstacle type
+        std::printf("%8s %6s %8s %8s %5s %5s %5s %5s | %6s", "lifetime", "spawn", "games", "mean",
+            "p50", "p90", "p99", "max", "fell%");
+        forEachObstacleType(ObstacleTypes(), [](auto trait) {
+            std::printf(" %9s", (std::string(decltype(trait)::NAME) + "%").c_str());
+        });
+        std::printf(" %6s\n", "tout%");
+        long long totalGames = 0, totalTicks = 0;
+        for (const auto& stats : results) {
+            double perGame = stats.games ? 100.0 / stats.games : 0.0;
+            std::printf("%8.2f %6.2f %8ld %8.2f %5d %5d %5d %5d | %6.2f",
+                stats.tuning.platformLifetime, stats.tuning.obstacleSpawnChance, stats.games,
+                stats.meanScore(), stats.scorePercentile(0.5), stats.scorePercentile(0.9),
+                stats.scorePercentile(0.99), stats.maxScore(),
+                stats.fellOff * perGame);
+            forEachObstacleType(ObstacleTypes(), [&](auto trait) {
+                std::printf(" %9.2f", stats.hitBy[decltype(trait)::TYPE] * perGame);
+            });
+            std::printf(" %6.2f\n", stats.timeouts * perGame);
+            if (stats.errors) {
+                std::printf("         %ld games ended in a simulation error\n", stats.errors);
+            }
+            totalGames += stats.games;
+            totalTicks += stats.ticks;
+        }
+
+        unsigned threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+        std::printf("\n%lld games, %lld ticks in %.3f s on %u threads: %.0f games/s, %.3g ticks/s\n",
+            totalGames, totalTicks, seconds, threads, totalGames / seconds, totalTicks / seconds);
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Fatal error in crossy_batch: " << e.what() << std::endl;
+        return 1;
+    }
+}
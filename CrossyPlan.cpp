@@ -0,0 +1,100 @@
+// Search-based playtester: for every seed, searches for the best plan a
+// perfect player could follow within a time horizon (Planner.h), on all cores,
+// and prints whether the level is solvable and its best possible score.
+//
+// Usage: crossy_plan [--seed N] [--seeds N] [--threads N] [--dt SECONDS]
+//                    [--max-ticks N] [--target SCORE] [--wait-ticks N]
+//                    [--max-nodes N] [--save-best FILE]
+//
+// Seeds --seed, --seed + 1, ... are planned (--seeds of them). A seed is
+// solvable if a plan reaches --target, unsolvable if the search finished
+// without one, and unknown if it ran out of --max-nodes first. --save-best
+// saves the best plan for the first seed as a replay for crossy_sim --replay.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Planner.h"
+#include "Replay.h"
+
+int main(int argc, char** argv) {
+    try {
+        PlanConfig config;
+        uint64_t firstSeed = 1;
+        long seedCount = 16;
+        std::string saveFile;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--seed" && hasValue) firstSeed = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--seeds" && hasValue) seedCount = std::atol(argv[++i]);
+            else if (arg == "--threads" && hasValue) config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--dt" && hasValue) config.dt = static_cast<float>(std::atof(argv[++i]));
+            else if (arg == "--max-ticks" && hasValue) config.maxTicks = std::atol(argv[++i]);
+            else if (arg == "--target" && hasValue) config.targetScore = std::atoi(argv[++i]);
+            else if (arg == "--wait-ticks" && hasValue) config.waitTicks = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--max-nodes" && hasValue) config.maxNodes = std::atol(argv[++i]);
+            else if (arg == "--save-best" && hasValue) saveFile = argv[++i];
+            else {
+                std::cerr << "Usage: crossy_plan [--seed N] [--seeds N] [--threads N] [--dt SECONDS]\n"
+                    "                   [--max-ticks N] [--target SCORE] [--wait-ticks N]\n"
+                    "                   [--max-nodes N] [--save-best FILE]" << std::endl;
+                return 1;
+            }
+        }
+
+        std::vector<uint64_t> seeds;
+        for (long i = 0; i < seedCount; ++i) {
+            seeds.push_back(firstSeed + i);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<PlanResult> results = planSeeds(seeds, config);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("horizon %ld ticks (%.1f s), target score %d\n\n", config.maxTicks,
+            config.maxTicks * config.dt, config.targetScore);
+        std::printf("%12s %9s %6s %8s %10s %s\n", "seed", "solvable", "best", "at tick", "nodes", "search");
+        static const char* VERDICTS[] = { "unknown", "yes", "no" };
+        long solvable = 0, unknown = 0, exhaustive = 0;
+        long long nodes = 0;
+        for (const auto& result : results) {
+            std::printf("%12llu %9s %6d %8ld %10ld %s\n", static_cast<unsigned long long>(result.seed),
+                VERDICTS[static_cast<int>(result.solvable)], result.bestScore, result.bestTick, result.nodes,
+                result.exhaustive ? "complete" : "budget hit");
+            solvable += result.solvable == Solvability::SOLVABLE;
+            unknown += result.solvable == Solvability::UNKNOWN;
+            exhaustive += result.exhaustive;
+            nodes += result.nodes;
+        }
+
+        // Seeds the search could not decide are left out of the solvable count
+        unsigned threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+        std::printf("\n%ld of %ld seeds solvable (%ld unknown), %ld searched completely; %lld nodes in %.3f s"
+            " on %u threads (%.3g nodes/s)\n", solvable, static_cast<long>(results.size()) - unknown, unknown,
+            exhaustive, nodes, seconds, threads, seconds > 0.0 ? nodes / seconds : 0.0);
+
+        if (!saveFile.empty() && !results.empty()) {
+            ReplayRecorder recorder;
+            recorder.begin(results[0].seed, static_cast<float>(1.0 / config.dt));
+            for (uint8_t mask : results[0].bestInputs) {
+                recorder.record(mask);
+            }
+            saveReplay(recorder.replay(), saveFile);
+            std::printf("best plan for seed %llu saved to %s\n",
+                static_cast<unsigned long long>(results[0].seed), saveFile.c_str());
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Fatal error in crossy_plan: " << e.what() << std::endl;
+        return 1;
+    }
+}
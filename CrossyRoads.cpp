@@ -0,0 +1,547 @@
+#include <GL/glut.h>
+#ifdef FREEGLUT
+#include <GL/freeglut_ext.h>
+#endif
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Autopilot.h"
+#include "GLExtensions.h"
+#include "Game.h"
+#include "GameSnapshot.h"
+#include "PathStreamer.h"
+#include "Profiler.h"
+#include "Renderer.h"
+#include "Replay.h"
+#ifdef CROSSY_OFFSCREEN
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <system_error>
+#include "OffscreenContext.h"
+#endif
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// Generates the path ahead of the player so extending it never stalls a tick
+PathStreamer pathStreamer;
+Game game;
+Renderer renderer;
+RenderBackend requestedBackend = RenderBackend::RETAINED;
+SkyMode skyMode = SkyMode::DOME;
+uint64_t nextSeed = 0; // Seed for the next game; every restart gets a new level
+
+// Fixed-step simulation: the game always advances in ticks of 1 / tickRate seconds,
+// while frames are drawn as fast as vsync (or nothing, when it is off) allows
+float tickRate = 120.0f;
+bool vsync = true;
+double tickAccumulator = 0.0;
+std::chrono::steady_clock::time_point lastFrameTime;
+
+// Pose at the start of the current tick, and the one drawn this frame
+PlayerPose prevPose, pose;
+float renderAlpha = 1.0f;
+// Chrome trace written on exit, if set
+std::string profileTraceFile;
+
+// --record: the current game's input, saved when it ends (or on exit)
+std::string recordFile;
+ReplayRecorder recorder;
+bool recording = false;
+bool recordingUnsaved = false;
+
+// F5 / F9: quick save and quick load
+GameSnapshot quickSave;
+
+void startGame(uint64_t seed) {
+    game.reset(seed);
+    recording = !recordFile.empty();
+    if (recording) {
+        recorder.begin(seed, tickRate);
+        recordingUnsaved = false;
+    }
+}
+
+void saveRecording() {
+    if (!recordingUnsaved) return;
+    recordingUnsaved = false;
+    try {
+        saveReplay(recorder.replay(), recordFile);
+        std::cout << "Replay of seed " << recorder.replay().seed << " (" << recorder.replay().tickCount
+            << " ticks) saved to " << recordFile << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in saveRecording: " << e.what() << std::endl;
+    }
+}
+
+void writeProfileTrace() {
+    if (profileTraceFile.empty()) return;
+    if (!Profiler::COMPILED_IN) {
+        std::cerr << "Profiler not compiled in; no trace written" << std::endl;
+    }
+    else if (profiler.writeChromeTrace(profileTraceFile)) {
+        std::cout << "Profile trace written to " << profileTraceFile << std::endl;
+    }
+    else {
+        std::cerr << "Cannot write profile trace " << profileTraceFile << std::endl;
+    }
+}
+
+// Remembers the state the next tick starts from, for interpolation
+void captureTickStart() {
+    prevPose = capturePose(game);
+}
+
+float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+PlayerPose interpolatePose(const PlayerPose& a, const PlayerPose& b, float t) {
+    // Only blend within one movement; across a landing or the start of a move show the newer tick
+    if (a.isRolling != b.isRolling || a.isJumping != b.isJumping || a.rollDirection != b.rollDirection) {
+        return b;
+    }
+    PlayerPose p = b;
+    p.x = lerp(a.x, b.x, t);
+    p.y = lerp(a.y, b.y, t);
+    p.z = lerp(a.z, b.z, t);
+    p.jumpHeight = lerp(a.jumpHeight, b.jumpHeight, t);
+    p.jumpProgress = lerp(a.jumpProgress, b.jumpProgress, t);
+    p.rollAngle = lerp(a.rollAngle, b.rollAngle, t);
+    return p;
+}
+
+void setSwapInterval(int interval) {
+#ifdef FREEGLUT
+    typedef int (APIENTRY* SwapIntervalProc)(int);
+    const char* names[] = { "glXSwapIntervalMESA", "glXSwapIntervalSGI", "wglSwapIntervalEXT" };
+    for (const char* name : names) {
+        SwapIntervalProc proc = reinterpret_cast<SwapIntervalProc>(glutGetProcAddress(name));
+        if (proc) {
+            proc(interval);
+            return;
+        }
+    }
+#endif
+    std::cerr << "No swap interval control; using the driver default" << std::endl;
+}
+
+// Draws the game as it stands renderAlpha of the way through the current tick
+void drawScene() {
+    pose = interpolatePose(prevPose, capturePose(game), renderAlpha);
+
+    // Obstacle motion is exact at any time, so they are shown at the in-between time itself
+    double obstacleTime = game.time - (1.0 - renderAlpha) / tickRate;
+    renderer.drawFrame(game, pose, obstacleTime);
+}
+
+void display() {
+    try {
+        drawScene();
+        glutSwapBuffers();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in display: " << e.what() << std::endl;
+        exit(1);
+    }
+}
+
+void idle() {
+    try {
+        auto now = std::chrono::steady_clock::now();
+        double frameTime = std::chrono::duration<double>(now - lastFrameTime).count();
+        lastFrameTime = now;
+
+        // After a stall, drop the missed time instead of fast-forwarding through it
+        if (frameTime > 0.1) frameTime = 0.1;
+
+        double tickTime = 1.0 / tickRate;
+        tickAccumulator += frameTime;
+        while (tickAccumulator >= tickTime) {
+            captureTickStart();
+            if (recording && !game.gameOver) {
+                recorder.record(inputMask(game));
+                recordingUnsaved = true;
+            }
+            game.updateGame(static_cast<float>(tickTime));
+            if (game.gameOver) saveRecording();
+            tickAccumulator -= tickTime;
+        }
+
+        renderAlpha = static_cast<float>(tickAccumulator / tickTime);
+        glutPostRedisplay();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in idle: " << e.what() << std::endl;
+        exit(1);
+    }
+}
+
+void reshape(int w, int h) {
+    try {
+        renderer.resize(w, h);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in reshape: " << e.what() << std::endl;
+        exit(1);
+    }
+}
+
+void keyboard(unsigned char key, int, int) {
+    try {
+        switch (key) {
+        case 'w': case 'W': game.keyW = true; break;
+        case 's': case 'S': game.keyS = true; break;
+        case 'a': case 'A': game.keyA = true; break;
+        case 'd': case 'D': game.keyD = true; break;
+        case ' ': game.keySpace = true; break;
+        case 'v': case 'V': game.nextCameraMode(); break;
+        case 'c': case 'C': game.toggleCameraRotation(); break;
+        case '+': case '=': game.zoomIn(); break;
+        case '-': case '_': game.zoomOut(); break;
+        case 'r': case 'R': saveRecording(); startGame(nextSeed++); captureTickStart(); break;
+        case 'p': case 'P': renderer.toggleProfilerOverlay(); break;
+        case 27: saveRecording(); writeProfileTrace(); exit(0); break;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in keyboard: " << e.what() << std::endl;
+    }
+}
+
+void specialKey(int key, int, int) {
+    try {
+        if (key == GLUT_KEY_F5) {
+            quickSave.capture(game);
+            std::cout << "Quick saved (" << quickSave.size() << " bytes)" << std::endl;
+        }
+        else if (key == GLUT_KEY_F9 && !quickSave.empty()) {
+            // A replay can't express the jump back, so end the recording here
+            saveRecording();
+            recording = false;
+            // Keep the keys as they are held now, not as they were at the save
+            uint8_t held = inputMask(game);
+            quickSave.restore(game);
+            applyInputMask(game, held);
+            captureTickStart();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in specialKey: " << e.what() << std::endl;
+    }
+}
+
+void keyboardUp(unsigned char key, int, int) {
+    try {
+        switch (key) {
+        case 'w': case 'W': game.keyW = false; break;
+        case 's': case 'S': game.keyS = false; break;
+        case 'a': case 'A': game.keyA = false; break;
+        case 'd': case 'D': game.keyD = false; break;
+        case ' ': game.keySpace = false; break;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in keyboardUp: " << e.what() << std::endl;
+    }
+}
+
+GLProc getGlutProc(const char* name) {
+#ifdef FREEGLUT
+    return reinterpret_cast<GLProc>(glutGetProcAddress(name));
+#else
+    (void)name;
+    return nullptr;
+#endif
+}
+
+#ifdef CROSSY_OFFSCREEN
+// --offscreen: draws a fixed number of frames of a seeded, bot-played game into
+// an offscreen context and reports frame time percentiles. Every frame advances
+// the simulation by exactly 1 / fps seconds, so the same options always draw the
+// same frames, whatever the machine.
+struct OffscreenOptions {
+    long frames = 600;
+    uint64_t seed = 1;
+    int width = 800, height = 600;
+    float fps = 60.0f;
+    int cameraMode = 0;
+    std::string dumpDir;   // Empty = no PPM dumps
+    long dumpEvery = 1;
+};
+OffscreenOptions offscreen;
+
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+void printFrameTimes(const char* label, std::vector<double> ms) {
+    std::sort(ms.begin(), ms.end());
+    double sum = 0.0;
+    for (double t : ms) sum += t;
+    std::printf("%-8s mean %7.3f  p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f ms\n", label,
+        sum / ms.size(), percentile(ms, 50), percentile(ms, 90), percentile(ms, 99), ms.back());
+}
+
+int runOffscreen() {
+    OffscreenContext context;
+    context.create(offscreen.width, offscreen.height);
+    renderer.init(requestedBackend, false);
+    renderer.setSkyMode(skyMode);
+    renderer.resize(offscreen.width, offscreen.height);
+
+    std::mt19937 inputRng(static_cast<uint32_t>(offscreen.seed));
+    uint64_t games = 0;
+    game.cameraMode = offscreen.cameraMode;  // Kept across resets
+    game.reset(offscreen.seed + games++);
+    captureTickStart();
+
+    // Submit = until drawFrame returns; total = until glFinish, i.e. the frame is
+    // fully rendered (with a software rasterizer that is CPU time as well)
+    std::vector<double> submitMs, totalMs;
+    submitMs.reserve(offscreen.frames);
+    totalMs.reserve(offscreen.frames);
+
+    drawScene();  // Warm-up: first-use driver work is not part of the measurement
+    glFinish();
+
+    double tickTime = 1.0 / tickRate;
+    for (long frame = 0; frame < offscreen.frames; ++frame) {
+        tickAccumulator += 1.0 / offscreen.fps;
+        while (tickAccumulator >= tickTime) {
+            if (game.gameOver) game.reset(offscreen.seed + games++);
+            captureTickStart();
+            botInput(game, inputRng);
+            game.updateGame(static_cast<float>(tickTime));
+            tickAccumulator -= tickTime;
+        }
+        renderAlpha = static_cast<float>(tickAccumulator / tickTime);
+
+        auto start = std::chrono::steady_clock::now();
+        drawScene();
+        auto submitted = std::chrono::steady_clock::now();
+        glFinish();
+        auto finished = std::chrono::steady_clock::now();
+        submitMs.push_back(std::chrono::duration<double, std::milli>(submitted - start).count());
+        totalMs.push_back(std::chrono::duration<double, std::milli>(finished - start).count());
+
+        if (!offscreen.dumpDir.empty() && frame % offscreen.dumpEvery == 0) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%05ld.ppm", frame);
+            context.writePPM(offscreen.dumpDir + name);
+        }
+    }
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "OpenGL error 0x" << std::hex << error << std::dec << " during offscreen run" << std::endl;
+    }
+
+    std::printf("renderer: %s, %s%s\n", context.rendererName(),
+        renderer.backend() == RenderBackend::RETAINED ? "retained" : "immediate",
+        renderer.instancing() ? " + instancing" : "");
+    std::printf("frames:   %ld at %dx%d, seed %llu, %g fps of simulated time, %llu game(s)\n",
+        offscreen.frames, offscreen.width, offscreen.height,
+        static_cast<unsigned long long>(offscreen.seed), offscreen.fps,
+        static_cast<unsigned long long>(games));
+    if (offscreen.frames > 0) {
+        printFrameTimes("submit", submitMs);
+        printFrameTimes("total", totalMs);
+    }
+
+    if (Profiler::COMPILED_IN) {
+        PhaseSummary cpu[static_cast<int>(ProfilePhase::COUNT)], gpu[static_cast<int>(ProfilePhase::COUNT)];
+        profiler.summarize(Profiler::CAPACITY, cpu, gpu);
+        std::printf("%-10s %28s %28s\n", "phase (ms)", "cpu min / avg / p99", "gpu min / avg / p99");
+        for (int phase = 0; phase < static_cast<int>(ProfilePhase::COUNT); ++phase) {
+            if (cpu[phase].samples == 0) continue;
+            std::printf("%-10s %8.3f / %7.3f / %7.3f", profilePhaseName(static_cast<ProfilePhase>(phase)),
+                cpu[phase].minMs, cpu[phase].avgMs, cpu[phase].p99Ms);
+            if (gpu[phase].samples > 0) {
+                std::printf(" %8.3f / %7.3f / %7.3f", gpu[phase].minMs, gpu[phase].avgMs, gpu[phase].p99Ms);
+            }
+            std::printf("\n");
+        }
+    }
+    writeProfileTrace();
+    return error == GL_NO_ERROR ? 0 : 1;
+}
+#endif
+
+void initGL() {
+    try {
+        glExt.load(getGlutProc);
+        renderer.init(requestedBackend, true);
+        renderer.setSkyMode(skyMode);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error in initGL: " << e.what() << std::endl;
+        throw;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        nextSeed = static_cast<uint64_t>(std::time(0));
+        game.pathStreamer = &pathStreamer;
+
+        // Offscreen runs never open a window, so GLUT is left uninitialized
+        bool offscreenRun = false;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--offscreen") == 0) offscreenRun = true;
+        }
+
+        if (!offscreenRun) {
+            glutInit(&argc, argv);
+            if (argc < 1) {
+                std::cerr << "GLUT initialization failed!" << std::endl;
+                return -1;
+            }
+        }
+
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+                tickRate = static_cast<float>(std::atof(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--vsync") == 0) {
+                vsync = true;
+            }
+            else if (std::strcmp(argv[i], "--no-vsync") == 0) {
+                vsync = false;
+            }
+            else if (std::strcmp(argv[i], "--renderer") == 0 && i + 1 < argc) {
+                std::string name = argv[++i];
+                if (name == "retained") requestedBackend = RenderBackend::RETAINED;
+                else if (name == "immediate") requestedBackend = RenderBackend::IMMEDIATE;
+                else {
+                    std::cerr << "Unknown renderer: " << name << std::endl;
+                    return -1;
+                }
+            }
+            else if (std::strcmp(argv[i], "--sky") == 0 && i + 1 < argc) {
+                std::string name = argv[++i];
+                if (name == "dome") skyMode = SkyMode::DOME;
+                else if (name == "gradient") skyMode = SkyMode::GRADIENT;
+                else {
+                    std::cerr << "Unknown sky: " << name << std::endl;
+                    return -1;
+                }
+            }
+            else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                recordFile = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--profile-trace") == 0 && i + 1 < argc) {
+                profileTraceFile = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--offscreen") == 0) {
+                // Already seen before glutInit
+            }
+#ifdef CROSSY_OFFSCREEN
+            else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+                offscreen.frames = std::atol(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                offscreen.seed = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+                if (std::sscanf(argv[++i], "%dx%d", &offscreen.width, &offscreen.height) != 2) {
+                    std::cerr << "Size must be WIDTHxHEIGHT" << std::endl;
+                    return -1;
+                }
+            }
+            else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+                offscreen.fps = static_cast<float>(std::atof(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--camera") == 0 && i + 1 < argc) {
+                offscreen.cameraMode = std::atoi(argv[++i]) & 3;
+            }
+            else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+                offscreen.dumpDir = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--dump-every") == 0 && i + 1 < argc) {
+                offscreen.dumpEvery = std::atol(argv[++i]);
+            }
+#endif
+            else {
+                std::cerr << "Usage: crossy_roads [--tick-rate HZ] [--vsync | --no-vsync] "
+                    "[--renderer retained|immediate] [--sky dome|gradient] [--profile-trace FILE] "
+                    "[--record FILE]" << std::endl;
+#ifdef CROSSY_OFFSCREEN
+                std::cerr << "       crossy_roads --offscreen [--frames N] [--seed N] [--size WxH] "
+                    "[--fps N] [--camera 0-3] [--dump DIR] [--dump-every N] [--tick-rate HZ] "
+                    "[--renderer retained|immediate] [--sky dome|gradient] [--profile-trace FILE]" << std::endl;
+#endif
+                return -1;
+            }
+        }
+        if (tickRate <= 0.0f) {
+            std::cerr << "Tick rate must be positive" << std::endl;
+            return -1;
+        }
+
+        if (offscreenRun) {
+#ifdef CROSSY_OFFSCREEN
+            if (offscreen.frames < 0 || offscreen.fps <= 0.0f || offscreen.dumpEvery <= 0) {
+                std::cerr << "Frame count, fps and dump interval must be positive" << std::endl;
+                return -1;
+            }
+            // Create the dump directory up front, so a bad path fails before the run starts
+            if (!offscreen.dumpDir.empty()) {
+                std::error_code error;
+                std::filesystem::create_directories(offscreen.dumpDir, error);
+                if (error || !std::filesystem::is_directory(offscreen.dumpDir, error)) {
+                    std::cerr << "Cannot create dump directory " << offscreen.dumpDir << std::endl;
+                    return -1;
+                }
+            }
+            return runOffscreen();
+#else
+            std::cerr << "This build has no offscreen support; rebuild with -DCROSSY_OFFSCREEN" << std::endl;
+            return -1;
+#endif
+        }
+
+        glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH | GLUT_ALPHA);
+        glutInitWindowSize(800, 600);
+        glutCreateWindow("Crossy Roads");
+
+        if (!glutGetWindow()) {
+            std::cerr << "Window creation failed!" << std::endl;
+            return -1;
+        }
+
+        initGL();
+        setSwapInterval(vsync ? 1 : 0);
+        startGame(nextSeed++);
+        captureTickStart();
+        lastFrameTime = std::chrono::steady_clock::now();
+
+        glutDisplayFunc(display);
+        glutReshapeFunc(reshape);
+        glutKeyboardFunc(keyboard);
+        glutKeyboardUpFunc(keyboardUp);
+        glutSpecialFunc(specialKey);
+        glutIdleFunc(idle);
+
+        std::cout << "Game initialized successfully" << std::endl;
+        glutMainLoop();
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Fatal error in main: " << e.what() << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
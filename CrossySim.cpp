@@ -0,0 +1,373 @@
+// Headless simulation runner: steps Game::updateGame with a fixed timestep and
+// scripted, random or bot input, restarting after every game over, and reports
+// simulation throughput. Needs no display, GLUT or OpenGL.
+//
+// Usage: crossy_sim [--ticks N] [--dt SECONDS] [--seed N]
+//                   [--input random|bot] [--script FILE] [--record FILE] [--async-path]
+//                   [--count-allocs]
+//        crossy_sim --replay FILE [--seek TICK]
+//        crossy_sim --verify-golden
+//        crossy_sim --verify-sweep
+//
+// A script file holds one "<tick> <keys>" line per input change, where keys is
+// any combination of W A S D and J (jump / space), or "-" for no keys. Each
+// line's keys stay held until the next line; the script restarts every game.
+//
+// --verify-golden regenerates the worlds of a few fixed seeds and compares
+// their hashes with known-good values, so any change to world generation or
+// the RNG that would break reproducibility is caught. Exits non-zero on mismatch.
+//
+// --verify-sweep plays the same jump or roll past every obstacle type, spawned
+// at a range of times, at tick lengths from 1/960 s to 0.1 s, and checks that
+// the swept collision test gives the same outcome, and the same point of
+// contact, at every tick length. Exits non-zero on mismatch.
+//
+// --record saves the first game of the run as a replay. --replay re-simulates a
+// replay (recorded here or by crossy_roads --record) and prints how it ended;
+// with --seek it also jumps to the given tick and prints the state there.
+//
+// --async-path generates path segments on a worker thread (PathStreamer); the
+// results must be exactly those of a run without it.
+//
+// --count-allocs counts heap allocations once the first tenth of the ticks
+// has warmed up the containers, across game overs and resets, and exits
+// non-zero if there were any: steady-state play must not allocate.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Autopilot.h"
+#include "Game.h"
+#include "PathStreamer.h"
+#include "Replay.h"
+
+// Global allocation functions that count calls while countingAllocs is set
+// (the array and sized forms all end up in these)
+static std::atomic<bool> countingAllocs{ false };
+static std::atomic<long long> allocCount{ 0 };
+
+static void* countedAlloc(std::size_t size, std::size_t alignment) {
+    if (countingAllocs.load(std::memory_order_relaxed)) {
+        allocCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (size == 0) size = 1;
+    void* p = alignment <= alignof(std::max_align_t)
+        ? std::malloc(size)
+        : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// World hashes after reset(seed) and GOLDEN_EXTENSIONS calls to extendPath()
+static constexpr int GOLDEN_EXTENSIONS = 20;
+static const struct {
+    uint64_t seed;
+    uint64_t hash;
+} GOLDEN_WORLDS[] = {
+    { 1, 0xda19c6881cac205cull },
+    { 2, 0xa37d26c945eb5050ull },
+    { 42, 0x9126b90a1e499a21ull },
+    { 1234567, 0x70e0159e596a20bfull },
+    { 0xDEADBEEFull, 0x27aff8e167ad22f4ull },
+};
+
+static bool verifyGolden() {
+    bool ok = true;
+    for (const auto& golden : GOLDEN_WORLDS) {
+        Game game;
+        game.reset(golden.seed);
+        for (int i = 0; i < GOLDEN_EXTENSIONS; ++i) {
+            game.extendPath();
+        }
+        uint64_t hash = game.worldHash();
+        bool match = hash == golden.hash;
+        ok = ok && match;
+        std::cout << "seed " << golden.seed << ": " << std::hex << "0x" << hash
+            << (match ? " ok" : " MISMATCH, expected 0x") << std::dec;
+        if (!match) std::cout << std::hex << golden.hash << std::dec;
+        std::cout << std::endl;
+    }
+    return ok;
+}
+
+// Tick lengths --verify-sweep compares, finest first
+static const float SWEEP_TICKS[] = { 1.0f / 960.0f, 1.0f / 120.0f, 1.0f / 60.0f, 1.0f / 20.0f, 0.1f };
+// Furthest apart two tick lengths may place the same contact, in move progress
+static constexpr float SWEEP_TOLERANCE = 2.0f * Game::MIN_SWEEP_STEP + 1e-5f;
+
+struct SweepOutcome {
+    Game::ObstacleType hitBy;
+    float progress;  // Of the move at the contact
+};
+
+// Plays one move starting at game time 5 s: from (0, 0) along +x, over an
+// obstacle of the given type on cell (obstacleX, 0) that spawned spawnAge
+// seconds before the move started
+static SweepOutcome playSweep(bool jump, Game::ObstacleType type, int obstacleX, double spawnAge, float dt) {
+    const double moveStart = 5.0;
+    Game game;
+    game.pathCursor.maxX = 1000;  // Far enough that landing never extends the path
+    for (int x = 0; x <= 3; ++x) {
+        game.addTile(x, 0, false);
+    }
+    game.addObstacle({ obstacleX, 0, type, true, moveStart - spawnAge });
+    game.time = moveStart - dt;  // The tick that reads the keys starts the move at moveStart
+
+    applyKeys(game, jump ? "DJ" : "D");
+    game.updateGame(dt);
+    applyKeys(game, "");
+    while ((game.isJumping || game.isRolling) && !game.gameOver) {
+        game.updateGame(dt);
+    }
+    if (!game.gameOver) return { Game::NONE, 1.0f };
+    return { game.killedBy, jump ? game.jumpProgress : game.rollProgress };
+}
+
+static bool verifySweep() {
+    bool ok = true;
+    long cases = 0, hits = 0;
+    for (bool jump : { true, false }) {
+        for (int type = 1; type <= static_cast<int>(ObstacleTypes::COUNT); ++type) {
+            for (int obstacleX = 1; obstacleX <= (jump ? 2 : 1); ++obstacleX) {
+                // Spawn ages sit half a step off the 1/32 s grid: on it, some blocks just
+                // touch the player as it lands, with a gap of exactly zero that rounding decides
+                for (int i = 0; i < 96; ++i) {
+                    double spawnAge = (i + 0.5) / 32.0;
+                    auto obstacleType = static_cast<Game::ObstacleType>(type);
+                    SweepOutcome reference = playSweep(jump, obstacleType, obstacleX, spawnAge, SWEEP_TICKS[0]);
+                    ++cases;
+                    hits += reference.hitBy != Game::NONE;
+                    for (float dt : SWEEP_TICKS) {
+                        SweepOutcome outcome = playSweep(jump, obstacleType, obstacleX, spawnAge, dt);
+                        if (outcome.hitBy == reference.hitBy
+                            && std::fabs(outcome.progress - reference.progress) <= SWEEP_TOLERANCE) continue;
+                        ok = false;
+                        std::cout << (jump ? "jump" : "roll") << " past " << obstacleTypeName(type) << " on x = "
+                            << obstacleX << ", spawned " << spawnAge << " s before: dt " << dt << " gives "
+                            << obstacleTypeName(outcome.hitBy) << " at " << outcome.progress << ", dt "
+                            << SWEEP_TICKS[0] << " gives " << obstacleTypeName(reference.hitBy) << " at "
+                            << reference.progress << " MISMATCH" << std::endl;
+                    }
+                }
+            }
+        }
+    }
+    std::cout << cases << " moves (" << hits << " hits) at " << sizeof(SWEEP_TICKS) / sizeof(SWEEP_TICKS[0])
+        << " tick lengths: " << (ok ? "ok" : "MISMATCH") << std::endl;
+    return ok;
+}
+
+static const char* DEATH_CAUSES[] = { "alive", "fell off", "hit obstacle", "simulation error" };
+
+static void printState(const Game& game) {
+    std::cout << "score:          " << game.score << "\n"
+        << "player:         " << game.playerX << ", " << game.playerY << ", " << game.playerZ << "\n"
+        << "state:          " << DEATH_CAUSES[game.deathCause] << "\n"
+        << "world hash:     0x" << std::hex << game.worldHash() << std::dec << std::endl;
+}
+
+static int playReplay(const std::string& fileName, long seekTick) {
+    Replay replay = loadReplay(fileName);
+    std::cout << "replay:         seed " << replay.seed << ", " << replay.tickRate << " Hz, "
+        << replay.tickCount << " ticks, " << replay.inputs.size() << " input bytes" << std::endl;
+
+    ReplayPlayer player(replay);
+    auto start = std::chrono::steady_clock::now();
+    player.run();
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printState(player.game());
+    std::cout << "ticks/second:   " << (seconds > 0.0 ? replay.tickCount / seconds : 0.0) << std::endl;
+
+    if (seekTick >= 0) {
+        start = std::chrono::steady_clock::now();
+        player.seek(static_cast<uint64_t>(seekTick));
+        end = std::chrono::steady_clock::now();
+        std::cout << "\nat tick " << player.tick() << " (seek took "
+            << std::chrono::duration<double, std::milli>(end - start).count() << " ms):\n";
+        printState(player.game());
+    }
+    return 0;
+}
+
+static void saveRecording(const Replay& replay, const std::string& fileName, const Game& game) {
+    saveReplay(replay, fileName);
+    std::cout << "recorded " << replay.tickCount << " ticks (" << replay.inputs.size() << " input bytes) to "
+        << fileName << ":\n";
+    printState(game);
+    std::cout << std::endl;
+}
+
+struct ScriptEntry {
+    long tick;
+    std::string keys;
+};
+
+static std::vector<ScriptEntry> loadScript(const std::string& fileName) {
+    std::ifstream in(fileName);
+    if (!in) {
+        throw std::runtime_error("cannot open script " + fileName);
+    }
+    std::vector<ScriptEntry> script;
+    ScriptEntry entry;
+    while (in >> entry.tick >> entry.keys) {
+        script.push_back(entry);
+    }
+    return script;
+}
+
+int main(int argc, char** argv) {
+    try {
+        long totalTicks = 1000000;
+        float dt = 1.0f / 60.0f;
+        uint64_t seed = 1;
+        std::string input = "bot";
+        std::vector<ScriptEntry> script;
+        std::string recordFile, replayFile;
+        long seekTick = -1;
+        bool asyncPath = false;
+        bool countAllocs = false;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--ticks" && hasValue) totalTicks = std::atol(argv[++i]);
+            else if (arg == "--dt" && hasValue) dt = static_cast<float>(std::atof(argv[++i]));
+            else if (arg == "--seed" && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--verify-golden") return verifyGolden() ? 0 : 1;
+            else if (arg == "--verify-sweep") return verifySweep() ? 0 : 1;
+            else if (arg == "--input" && hasValue) input = argv[++i];
+            else if (arg == "--script" && hasValue) {
+                script = loadScript(argv[++i]);
+                input = "script";
+            }
+            else if (arg == "--record" && hasValue) recordFile = argv[++i];
+            else if (arg == "--replay" && hasValue) replayFile = argv[++i];
+            else if (arg == "--seek" && hasValue) seekTick = std::atol(argv[++i]);
+            else if (arg == "--async-path") asyncPath = true;
+            else if (arg == "--count-allocs") countAllocs = true;
+            else {
+                std::cerr << "Usage: crossy_sim [--ticks N] [--dt SECONDS] [--seed N] "
+                    "[--input random|bot] [--script FILE] [--record FILE] [--async-path] [--count-allocs]\n"
+                    "       crossy_sim --replay FILE [--seek TICK]\n"
+                    "       crossy_sim --verify-golden\n"
+                    "       crossy_sim --verify-sweep" << std::endl;
+                return 1;
+            }
+        }
+        if (!replayFile.empty()) {
+            return playReplay(replayFile, seekTick);
+        }
+        if (input != "bot" && input != "random" && input != "script") {
+            std::cerr << "Unknown input mode: " << input << std::endl;
+            return 1;
+        }
+        // Recording appends to the replay and the path streamer restarts its thread on every reset
+        if (countAllocs && (!recordFile.empty() || asyncPath)) {
+            std::cerr << "--count-allocs cannot be combined with --record or --async-path" << std::endl;
+            return 1;
+        }
+
+        std::mt19937 inputRng(static_cast<uint32_t>(seed));
+
+        // Replays store a tick rate; make sure playback will step with exactly this dt
+        ReplayRecorder recorder;
+        bool recording = !recordFile.empty();
+        if (recording) {
+            recorder.begin(seed, static_cast<float>(1.0 / dt));
+            if (recorder.replay().tickTime() != dt) {
+                std::cerr << "dt " << dt << " cannot be stored exactly as a tick rate" << std::endl;
+                return 1;
+            }
+        }
+
+        // Game k of the run is generated from seed + k
+        Game game;
+        PathStreamer streamer;
+        if (asyncPath) game.pathStreamer = &streamer;
+        game.reset(seed);
+
+        long games = 1, gameTick = 0;
+        size_t scriptPos = 0;
+        long long scoreSum = 0;
+        int bestScore = 0;
+        long warmupTicks = totalTicks / 10;
+
+        auto start = std::chrono::steady_clock::now();
+        for (long tick = 0; tick < totalTicks; ++tick, ++gameTick) {
+            if (countAllocs && tick == warmupTicks) countingAllocs = true;
+            if (input == "bot") {
+                botInput(game, inputRng);
+            }
+            else if (input == "random") {
+                randomInput(game, inputRng);
+            }
+            else {
+                while (scriptPos < script.size() && script[scriptPos].tick <= gameTick) {
+                    applyKeys(game, script[scriptPos++].keys);
+                }
+            }
+
+            if (recording) recorder.record(inputMask(game));
+            game.updateGame(dt);
+
+            if (game.gameOver) {
+                if (recording) {
+                    saveRecording(recorder.replay(), recordFile, game);
+                    recording = false;
+                }
+                scoreSum += game.score;
+                bestScore = std::max(bestScore, game.score);
+                game.reset(seed + games);
+                ++games;
+                gameTick = -1;
+                scriptPos = 0;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        countingAllocs = false;
+        if (recording) saveRecording(recorder.replay(), recordFile, game);
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        long finished = games - 1;
+        std::cout << "input:          " << input << "\n"
+            << "ticks:          " << totalTicks << " (dt " << dt << " s)\n"
+            << "games finished: " << finished << "\n"
+            << "mean score:     " << (finished ? static_cast<double>(scoreSum) / finished : 0.0) << "\n"
+            << "best score:     " << std::max(bestScore, game.score) << "\n"
+            << "wall time:      " << seconds << " s\n"
+            << "ticks/second:   " << (seconds > 0.0 ? totalTicks / seconds : 0.0) << std::endl;
+        if (asyncPath) {
+            std::cout << "path segments:  " << streamer.streamed() << " streamed, " << streamer.missed()
+                << " generated inline" << std::endl;
+        }
+        if (countAllocs) {
+            std::cout << "allocations:    " << allocCount << " in the " << (totalTicks - warmupTicks)
+                << " ticks after warm-up" << std::endl;
+            return allocCount == 0 ? 0 : 1;
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Fatal error in crossy_sim: " << e.what() << std::endl;
+        return 1;
+    }
+}
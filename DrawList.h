@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Column-major 4x4 matrix, laid out the way glLoadMatrixf expects
+struct Mat4 {
+    float m[16];
+
+    static Mat4 identity() {
+        Mat4 r;
+        std::memset(r.m, 0, sizeof(r.m));
+        r.m[0] = r.m[5] = r.m[10] = r.m[15] = 1.0f;
+        return r;
+    }
+
+    static Mat4 translation(float x, float y, float z) {
+        Mat4 r = identity();
+        r.m[12] = x;
+        r.m[13] = y;
+        r.m[14] = z;
+        return r;
+    }
+
+    static Mat4 scaling(float x, float y, float z) {
+        Mat4 r = identity();
+        r.m[0] = x;
+        r.m[5] = y;
+        r.m[10] = z;
+        return r;
+    }
+
+    // As glRotatef: degrees about a unit axis
+    static Mat4 rotation(float degrees, float x, float y, float z) {
+        float radians = degrees * 3.14159265358979323846f / 180.0f;
+        float c = std::cos(radians), s = std::sin(radians), t = 1.0f - c;
+        Mat4 r = identity();
+        r.m[0] = t * x * x + c;     r.m[4] = t * x * y - s * z; r.m[8] = t * x * z + s * y;
+        r.m[1] = t * x * y + s * z; r.m[5] = t * y * y + c;     r.m[9] = t * y * z - s * x;
+        r.m[2] = t * x * z - s * y; r.m[6] = t * y * z + s * x; r.m[10] = t * z * z + c;
+        return r;
+    }
+
+    Mat4 operator*(const Mat4& o) const {
+        Mat4 r;
+        for (int col = 0; col < 4; ++col) {
+            for (int row = 0; row < 4; ++row) {
+                r.m[col * 4 + row] = m[row] * o.m[col * 4] + m[4 + row] * o.m[col * 4 + 1]
+                    + m[8 + row] * o.m[col * 4 + 2] + m[12 + row] * o.m[col * 4 + 3];
+            }
+        }
+        return r;
+    }
+};
+
+// One draw: which shape, in which material, where, and in which color. Batches
+// drawn with instancing also name their range of the frame's instance buffer.
+struct DrawCommand {
+    uint64_t key;
+    uint8_t material;
+    uint8_t shape;
+    uint8_t phase;  // Profiler phase the command's cost is attributed to; not part of the key
+    float color[4];
+    Mat4 model;
+    uint32_t firstInstance, instanceCount;
+};
+
+// Draw commands collected over a frame and sorted before any of them are sent
+// to OpenGL. Opaque commands come first, grouped by material and then shape, so
+// each material's state is set once; transparent commands follow from back to
+// front so they blend over everything behind them.
+class DrawList {
+public:
+    void clear() {
+        commandList.clear();
+        currentPhase = 0;
+    }
+
+    // Tags the commands added from now on
+    void setPhase(uint8_t phase) { currentPhase = phase; }
+
+    void addOpaque(uint8_t material, uint8_t shape, const Mat4& model, const float* color,
+        uint32_t firstInstance = 0, uint32_t instanceCount = 0) {
+        uint64_t key = (static_cast<uint64_t>(material) << 56) | (static_cast<uint64_t>(shape) << 48);
+        add(key, material, shape, model, color, firstInstance, instanceCount);
+    }
+
+    // depth is the distance in front of the eye; greater depths are drawn first
+    void addTransparent(float depth, uint8_t material, uint8_t shape, const Mat4& model, const float* color,
+        uint32_t firstInstance = 0, uint32_t instanceCount = 0) {
+        // Non-negative floats order like their bit patterns, so the inverted bits sort far to near
+        uint32_t depthBits;
+        float clamped = std::max(depth, 0.0f);
+        std::memcpy(&depthBits, &clamped, sizeof(depthBits));
+        uint64_t key = TRANSPARENT_BIT | (static_cast<uint64_t>(~depthBits) << 16)
+            | (static_cast<uint64_t>(material) << 8) | shape;
+        add(key, material, shape, model, color, firstInstance, instanceCount);
+    }
+
+    void sort() {
+        std::sort(commandList.begin(), commandList.end(),
+            [](const DrawCommand& a, const DrawCommand& b) { return a.key < b.key; });
+    }
+
+    const std::vector<DrawCommand>& commands() const { return commandList; }
+
+private:
+    static constexpr uint64_t TRANSPARENT_BIT = 1ull << 63;
+
+    void add(uint64_t key, uint8_t material, uint8_t shape, const Mat4& model, const float* color,
+        uint32_t firstInstance, uint32_t instanceCount) {
+        commandList.push_back({ key, material, shape, currentPhase, { color[0], color[1], color[2], color[3] },
+            model, firstInstance, instanceCount });
+    }
+
+    std::vector<DrawCommand> commandList;
+    uint8_t currentPhase = 0;
+};
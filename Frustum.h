@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cmath>
+
+// Clip planes of a perspective view, pulled out of the combined projection *
+// modelview matrix (Gribb & Hartmann), for rejecting bounding spheres on the
+// CPU before anything about them reaches OpenGL. Planes point inwards and are
+// normalized, so a plane equation gives signed distance in world units.
+class Frustum {
+public:
+    // Matrices in OpenGL's column-major layout, as returned by glGetFloatv
+    void extract(const float* projection, const float* modelview) {
+        float m[16];
+        for (int col = 0; col < 4; ++col) {
+            for (int row = 0; row < 4; ++row) {
+                m[col * 4 + row] = projection[0 * 4 + row] * modelview[col * 4 + 0]
+                    + projection[1 * 4 + row] * modelview[col * 4 + 1]
+                    + projection[2 * 4 + row] * modelview[col * 4 + 2]
+                    + projection[3 * 4 + row] * modelview[col * 4 + 3];
+            }
+        }
+
+        // Each plane is row 3 of the clip matrix plus or minus one of rows 0-2
+        for (int i = 0; i < 6; ++i) {
+            int axis = i / 2;
+            float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+            for (int c = 0; c < 4; ++c) {
+                planes[i][c] = m[c * 4 + 3] + sign * m[c * 4 + axis];
+            }
+            normalize(planes[i]);
+        }
+
+        // Eye-space depth plane, for limitDepth()
+        for (int c = 0; c < 4; ++c) {
+            depthPlane[c] = -modelview[c * 4 + 2];
+        }
+        normalize(depthPlane);
+    }
+
+    // Pulls the far plane in to the given eye-space depth, if that is nearer. The far
+    // plane of a perspective view faces the eye, so it is the depth plane at distance far.
+    void limitDepth(float maxDepth) {
+        float* farPlane = planes[PLANE_FAR];
+        if (maxDepth < farPlane[3] + depthPlane[3]) {
+            farPlane[0] = -depthPlane[0];
+            farPlane[1] = -depthPlane[1];
+            farPlane[2] = -depthPlane[2];
+            farPlane[3] = maxDepth - depthPlane[3];
+        }
+    }
+
+    // Distance of a point in front of the eye, along the view direction
+    float depth(float x, float y, float z) const {
+        return depthPlane[0] * x + depthPlane[1] * y + depthPlane[2] * z + depthPlane[3];
+    }
+
+    bool containsSphere(float x, float y, float z, float radius) const {
+        for (const auto& p : planes) {
+            if (p[0] * x + p[1] * y + p[2] * z + p[3] < -radius) return false;
+        }
+        return true;
+    }
+
+private:
+    enum { PLANE_LEFT, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR };
+
+    static void normalize(float* plane) {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        for (int c = 0; c < 4; ++c) plane[c] /= length;
+    }
+
+    float planes[6][4] = {};
+    float depthPlane[4] = {};  // Gives a point's eye-space depth (distance in front of the eye)
+};
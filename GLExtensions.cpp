@@ -0,0 +1,87 @@
+#include "GLExtensions.h"
+
+#include <cstdio>
+#include <cstring>
+
+GLExtensions glExt;
+
+template <typename Proc>
+static bool loadProc(GLProcLoader getProc, Proc& proc, const char* name) {
+    proc = reinterpret_cast<Proc>(getProc(name));
+    return proc != nullptr;
+}
+
+void GLExtensions::load(GLProcLoader getProc) {
+    // Some loaders hand out pointers for any name, so the version decides what is usable
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (!version || std::sscanf(version, "%d.%d", &versionMajor, &versionMinor) != 2) {
+        versionMajor = 1;
+        versionMinor = 0;
+    }
+
+    hasBuffers = versionAtLeast(1, 5);
+    hasBuffers = loadProc(getProc, GenBuffers, "glGenBuffers") && hasBuffers;
+    hasBuffers = loadProc(getProc, DeleteBuffers, "glDeleteBuffers") && hasBuffers;
+    hasBuffers = loadProc(getProc, BindBuffer, "glBindBuffer") && hasBuffers;
+    hasBuffers = loadProc(getProc, BufferData, "glBufferData") && hasBuffers;
+    hasBuffers = loadProc(getProc, BufferSubData, "glBufferSubData") && hasBuffers;
+
+    hasShaders = versionAtLeast(2, 0);
+    hasShaders = loadProc(getProc, CreateShader, "glCreateShader") && hasShaders;
+    hasShaders = loadProc(getProc, DeleteShader, "glDeleteShader") && hasShaders;
+    hasShaders = loadProc(getProc, ShaderSource, "glShaderSource") && hasShaders;
+    hasShaders = loadProc(getProc, CompileShader, "glCompileShader") && hasShaders;
+    hasShaders = loadProc(getProc, GetShaderiv, "glGetShaderiv") && hasShaders;
+    hasShaders = loadProc(getProc, GetShaderInfoLog, "glGetShaderInfoLog") && hasShaders;
+    hasShaders = loadProc(getProc, CreateProgram, "glCreateProgram") && hasShaders;
+    hasShaders = loadProc(getProc, DeleteProgram, "glDeleteProgram") && hasShaders;
+    hasShaders = loadProc(getProc, AttachShader, "glAttachShader") && hasShaders;
+    hasShaders = loadProc(getProc, BindAttribLocation, "glBindAttribLocation") && hasShaders;
+    hasShaders = loadProc(getProc, LinkProgram, "glLinkProgram") && hasShaders;
+    hasShaders = loadProc(getProc, GetProgramiv, "glGetProgramiv") && hasShaders;
+    hasShaders = loadProc(getProc, GetProgramInfoLog, "glGetProgramInfoLog") && hasShaders;
+    hasShaders = loadProc(getProc, UseProgram, "glUseProgram") && hasShaders;
+    hasShaders = loadProc(getProc, GetUniformLocation, "glGetUniformLocation") && hasShaders;
+    hasShaders = loadProc(getProc, Uniform1f, "glUniform1f") && hasShaders;
+    hasShaders = loadProc(getProc, Uniform1i, "glUniform1i") && hasShaders;
+    hasShaders = loadProc(getProc, Uniform3f, "glUniform3f") && hasShaders;
+    hasShaders = loadProc(getProc, Uniform4f, "glUniform4f") && hasShaders;
+    hasShaders = loadProc(getProc, EnableVertexAttribArray, "glEnableVertexAttribArray") && hasShaders;
+    hasShaders = loadProc(getProc, DisableVertexAttribArray, "glDisableVertexAttribArray") && hasShaders;
+    hasShaders = loadProc(getProc, VertexAttribPointer, "glVertexAttribPointer") && hasShaders;
+
+    hasFramebuffers = versionAtLeast(3, 0);
+    hasFramebuffers = loadProc(getProc, GenFramebuffers, "glGenFramebuffers") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, DeleteFramebuffers, "glDeleteFramebuffers") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, BindFramebuffer, "glBindFramebuffer") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, FramebufferTexture2D, "glFramebufferTexture2D") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, CheckFramebufferStatus, "glCheckFramebufferStatus") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, GenRenderbuffers, "glGenRenderbuffers") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, DeleteRenderbuffers, "glDeleteRenderbuffers") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, BindRenderbuffer, "glBindRenderbuffer") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, RenderbufferStorage, "glRenderbufferStorage") && hasFramebuffers;
+    hasFramebuffers = loadProc(getProc, FramebufferRenderbuffer, "glFramebufferRenderbuffer") && hasFramebuffers;
+
+    hasInstancing = versionAtLeast(3, 3) && hasBuffers && hasShaders;
+    hasInstancing = loadProc(getProc, DrawElementsInstanced, "glDrawElementsInstanced") && hasInstancing;
+    hasInstancing = loadProc(getProc, VertexAttribDivisor, "glVertexAttribDivisor") && hasInstancing;
+
+    hasTimerQueries = versionAtLeast(3, 3) || hasExtension("GL_ARB_timer_query");
+    hasTimerQueries = loadProc(getProc, GenQueries, "glGenQueries") && hasTimerQueries;
+    hasTimerQueries = loadProc(getProc, DeleteQueries, "glDeleteQueries") && hasTimerQueries;
+    hasTimerQueries = loadProc(getProc, BeginQuery, "glBeginQuery") && hasTimerQueries;
+    hasTimerQueries = loadProc(getProc, EndQuery, "glEndQuery") && hasTimerQueries;
+    hasTimerQueries = loadProc(getProc, GetQueryObjectui64v, "glGetQueryObjectui64v") && hasTimerQueries;
+}
+
+bool GLExtensions::hasExtension(const char* name) {
+    const char* list = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    if (!list) return false;
+    size_t length = std::strlen(name);
+    for (const char* p = std::strstr(list, name); p; p = std::strstr(p + length, name)) {
+        bool startOk = p == list || p[-1] == ' ';
+        bool endOk = p[length] == ' ' || p[length] == '\0';
+        if (startOk && endOk) return true;
+    }
+    return false;
+}
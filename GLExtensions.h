@@ -0,0 +1,86 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// OpenGL entry points newer than 1.1, looked up at runtime so the same code
+// works with opengl32.dll, libGL and EGL contexts alike. load() must be called
+// once a context is current; the has* flags say which groups are usable.
+typedef void (*GLProc)();
+typedef GLProc (*GLProcLoader)(const char* name);
+
+struct GLExtensions {
+    int versionMajor = 1, versionMinor = 0;
+
+    // Vertex buffer objects (GL 1.5)
+    bool hasBuffers = false;
+    PFNGLGENBUFFERSPROC GenBuffers = nullptr;
+    PFNGLDELETEBUFFERSPROC DeleteBuffers = nullptr;
+    PFNGLBINDBUFFERPROC BindBuffer = nullptr;
+    PFNGLBUFFERDATAPROC BufferData = nullptr;
+    PFNGLBUFFERSUBDATAPROC BufferSubData = nullptr;
+
+    // GLSL programs and generic vertex attributes (GL 2.0)
+    bool hasShaders = false;
+    PFNGLCREATESHADERPROC CreateShader = nullptr;
+    PFNGLDELETESHADERPROC DeleteShader = nullptr;
+    PFNGLSHADERSOURCEPROC ShaderSource = nullptr;
+    PFNGLCOMPILESHADERPROC CompileShader = nullptr;
+    PFNGLGETSHADERIVPROC GetShaderiv = nullptr;
+    PFNGLGETSHADERINFOLOGPROC GetShaderInfoLog = nullptr;
+    PFNGLCREATEPROGRAMPROC CreateProgram = nullptr;
+    PFNGLDELETEPROGRAMPROC DeleteProgram = nullptr;
+    PFNGLATTACHSHADERPROC AttachShader = nullptr;
+    PFNGLBINDATTRIBLOCATIONPROC BindAttribLocation = nullptr;
+    PFNGLLINKPROGRAMPROC LinkProgram = nullptr;
+    PFNGLGETPROGRAMIVPROC GetProgramiv = nullptr;
+    PFNGLGETPROGRAMINFOLOGPROC GetProgramInfoLog = nullptr;
+    PFNGLUSEPROGRAMPROC UseProgram = nullptr;
+    PFNGLGETUNIFORMLOCATIONPROC GetUniformLocation = nullptr;
+    PFNGLUNIFORM1FPROC Uniform1f = nullptr;
+    PFNGLUNIFORM1IPROC Uniform1i = nullptr;
+    PFNGLUNIFORM3FPROC Uniform3f = nullptr;
+    PFNGLUNIFORM4FPROC Uniform4f = nullptr;
+    PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray = nullptr;
+    PFNGLDISABLEVERTEXATTRIBARRAYPROC DisableVertexAttribArray = nullptr;
+    PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer = nullptr;
+
+    // Framebuffer objects (GL 3.0)
+    bool hasFramebuffers = false;
+    PFNGLGENFRAMEBUFFERSPROC GenFramebuffers = nullptr;
+    PFNGLDELETEFRAMEBUFFERSPROC DeleteFramebuffers = nullptr;
+    PFNGLBINDFRAMEBUFFERPROC BindFramebuffer = nullptr;
+    PFNGLFRAMEBUFFERTEXTURE2DPROC FramebufferTexture2D = nullptr;
+    PFNGLCHECKFRAMEBUFFERSTATUSPROC CheckFramebufferStatus = nullptr;
+    PFNGLGENRENDERBUFFERSPROC GenRenderbuffers = nullptr;
+    PFNGLDELETERENDERBUFFERSPROC DeleteRenderbuffers = nullptr;
+    PFNGLBINDRENDERBUFFERPROC BindRenderbuffer = nullptr;
+    PFNGLRENDERBUFFERSTORAGEPROC RenderbufferStorage = nullptr;
+    PFNGLFRAMEBUFFERRENDERBUFFERPROC FramebufferRenderbuffer = nullptr;
+
+    // Instanced drawing with per-instance attributes (GL 3.3)
+    bool hasInstancing = false;
+    PFNGLDRAWELEMENTSINSTANCEDPROC DrawElementsInstanced = nullptr;
+    PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor = nullptr;
+
+    // GL_TIME_ELAPSED queries (GL 3.3 or ARB_timer_query)
+    bool hasTimerQueries = false;
+    PFNGLGENQUERIESPROC GenQueries = nullptr;
+    PFNGLDELETEQUERIESPROC DeleteQueries = nullptr;
+    PFNGLBEGINQUERYPROC BeginQuery = nullptr;
+    PFNGLENDQUERYPROC EndQuery = nullptr;
+    PFNGLGETQUERYOBJECTUI64VPROC GetQueryObjectui64v = nullptr;
+
+    void load(GLProcLoader getProc);
+
+    bool versionAtLeast(int major, int minor) const {
+        return versionMajor > major || (versionMajor == major && versionMinor >= minor);
+    }
+    // Looks the name up in the context's extension string
+    static bool hasExtension(const char* name);
+};
+
+extern GLExtensions glExt;
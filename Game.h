@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "CellHash.h"
+#include "ObstacleTraits.h"
+#include "PathGenerator.h"
+#include "RingBuffer.h"
+#include "Rng.h"
+#include "TileStore.h"
+
+class PathStreamer;
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Simulation state and rules for one game. Has no windowing or OpenGL
+// dependency; the GLUT front end (CrossyRoads.cpp) and the headless runner
+// (CrossySim.cpp) both drive it through updateGame().
+// New state fields must also be added to GameSnapshot (GameSnapshot.cpp).
+class Game {
+public:
+    // Game state
+    int score = 0;
+    float playerX = 0, playerY = 1.0, playerZ = 0;
+    bool isRolling = false;
+    float rollAngle = 0.0f;
+    int rollDirection = 0; // 0=none, 1=forward, 2=backward, 3=left, 4=right
+    float rollProgress = 0.0f;
+    bool gameOver = false;
+    bool showDirections = true;
+    int maxDistanceTraveled = 0;
+
+
+    // Jump-movement mechanics
+    bool isJumping = false;
+    float jumpHeight = 0.0f;
+    float jumpProgress = 0.0f;
+    static constexpr float MAX_JUMP_HEIGHT = 1.5f;
+    static constexpr float JUMP_SPEED = 2.0f;
+    float jumpDestX = 0.0f, jumpDestZ = 0.0f;
+    float jumpStartX = 0.0f, jumpStartZ = 0.0f;
+
+    // Camera settings
+    int cameraMode = 0;
+    float cameraDistance = 8.0f;
+    float cameraAngle = 45.0f;
+    bool fixedCameraAngle = true;
+
+    // Movement controls
+    bool keyW = false;
+    bool keyS = false;
+    bool keyA = false;
+    bool keyD = false;
+    bool keySpace = false;
+
+    // Game settings
+    static constexpr int INITIAL_PATH_LENGTH = PATH_INITIAL_TILES;
+    static constexpr int PATH_SEGMENT_LENGTH = PATH_SEGMENT_TILES;
+    static constexpr float ROLL_SPEED = 3.0f;
+    // Distance from a cube's centre to the bottom edge it rolls over
+    static constexpr float ROLL_RADIUS = 0.70710678f;
+    // Shortest step of a swept collision test, in move progress; contacts shorter than this can be missed
+    static constexpr float MIN_SWEEP_STEP = 1e-4f;
+    static constexpr float CUBE_SIZE = 1.0f;
+    static constexpr float PLATFORM_LIFETIME = 3.0f;
+    static constexpr float PATH_EXTENSION_THRESHOLD = 10.0f;
+    // FIXED: Changed from 0.9 to 0.3 to increase obstacle spawn rate
+    static constexpr float OBSTACLE_SPAWN_CHANCE = 0.6f;
+    // Tiles (and obstacles) the chunk pools are sized for up front; expired tiles behind
+    // the player are retired and their chunks reused for the path ahead
+    static constexpr int PATH_WINDOW_CAPACITY = 128;
+
+    // Difficulty settings that can be tuned per game; defaults are the constants above
+    struct Tuning {
+        float platformLifetime = PLATFORM_LIFETIME;
+        float obstacleSpawnChance = OBSTACLE_SPAWN_CHANCE;
+        float straightObstacleChance = 0.8f; // Spawn chance in the middle of straight segments
+    };
+    Tuning tuning;
+
+    // Game elements
+    // Path tiles: parallel x, z, lifetime, max_lifetime and isCorner arrays
+    TileStore path{ PATH_WINDOW_CAPACITY };
+    // Lifetime decay kernel, picked once for the CPU we are running on
+    DecayKernel decayKernel = selectDecayKernel();
+
+    // World generation state, including the per-game random stream; the same
+    // seed always generates the same path and obstacles
+    uint64_t seed = 0;
+    PathCursor pathCursor;
+    // Optional: generates segments ahead on a worker thread (not owned, one game per streamer)
+    PathStreamer* pathStreamer = nullptr;
+
+    // Simulated seconds since reset; obstacle motion is a closed-form function of it
+    double time = 0.0;
+
+    // Obstacle types; their behaviour is defined by the traits in ObstacleTraits.h
+    enum ObstacleType {
+        NONE = 0,
+        RISING_BLOCK = RisingBlock::TYPE,
+        FALLING_BLOCK = FallingBlock::TYPE,
+        SPINNING_BLOCK = SpinningBlock::TYPE,
+        MOVING_BLOCK = MovingBlock::TYPE
+    };
+
+    // Obstacles store only where and when they appeared; their motion is
+    // evaluated from that on demand (obstaclePose) instead of being stepped
+    struct Obstacle {
+        int x, z;
+        ObstacleType type;
+        bool active;
+        double spawnTime;
+    };
+
+    using ObstaclePose = ::ObstaclePose;
+
+    // Pose of an obstacle at the given game time (times before its spawn give the spawn pose)
+    static ObstaclePose obstaclePose(const Obstacle& obstacle, double atTime);
+
+    RingBuffer<Obstacle> obstacles{ PATH_WINDOW_CAPACITY };
+
+    // Why the last game ended
+    enum DeathCause {
+        ALIVE = 0,
+        FELL_OFF = 1,      // Landed where there is no live tile
+        HIT_OBSTACLE = 2,  // Collided with the obstacle in killedBy
+        SIM_ERROR = 3      // updateGame threw
+    };
+
+    DeathCause deathCause = ALIVE;
+    ObstacleType killedBy = NONE;
+
+    void endGame(DeathCause cause, ObstacleType obstacle = NONE) {
+        gameOver = true;
+        deathCause = cause;
+        killedBy = obstacle;
+    }
+
+    // (x, z) -> sequence number of the tile in path, kept in sync with every change to path
+    CellHash tileIndex{ PATH_WINDOW_CAPACITY };
+    // (x, z) -> sequence number of the active obstacle standing on that cell (at most one per cell)
+    CellHash obstacleGrid{ PATH_WINDOW_CAPACITY };
+
+    // Helper function to append a tile to the path and index it
+    void addTile(int x, int z, bool isCorner) {
+        tileIndex.insert(x, z, static_cast<uint32_t>(path.endSeq()));
+        path.push_back(x, z, tuning.platformLifetime, tuning.platformLifetime, isCorner);
+    }
+
+    // Helper function to find the path index of a tile, -1 if there is none
+    int tileAt(int x, int z) const {
+        uint32_t seq = tileIndex.find(x, z);
+        return seq == CellHash::NOT_FOUND ? -1 : static_cast<int>(seq - static_cast<uint32_t>(path.frontSeq()));
+    }
+
+    // Drops expired tiles from the front of the path, along with the obstacles standing on them.
+    // Tiles further back start decaying no later than the ones ahead of them, so they expire in order.
+    void retireExpiredTiles();
+
+    // Helper function to add an obstacle and register it in the grid
+    void addObstacle(const Obstacle& obstacle);
+
+    // Helper function to take an obstacle out of play; only its own grid cell is touched
+    void deactivateObstacle(Obstacle& obstacle);
+
+    // Helper function to find the active obstacle on a cell, nullptr if there is none
+    Obstacle* obstacleAt(int x, int z) {
+        uint32_t seq = obstacleGrid.find(x, z);
+        return seq == CellHash::NOT_FOUND ? nullptr : &obstacles.atSeq(seq);
+    }
+
+    const Obstacle* obstacleAt(int x, int z) const {
+        uint32_t seq = obstacleGrid.find(x, z);
+        return seq == CellHash::NOT_FOUND ? nullptr : &obstacles.atSeq(seq);
+    }
+
+    // Helper function to check if a position is a corner in the path
+    bool isCornerPoint(int x, int z) const {
+        int index = tileAt(x, z);
+        return index >= 0 && path.isCorner(index);
+    }
+
+    // Helper function to check if a position is adjacent to a corner in the path
+    bool isAdjacentToCorner(int x, int z) const {
+        return isCornerPoint(x + 1, z) || isCornerPoint(x - 1, z) ||
+            isCornerPoint(x, z + 1) || isCornerPoint(x, z - 1);
+    }
+
+    // Helper function to check if a position already has an obstacle
+    bool hasObstacle(int x, int z) const {
+        return obstacleAt(x, z) != nullptr;
+    }
+
+    // Helper function to check if a position is adjacent to another obstacle
+    bool isAdjacentToObstacle(int x, int z) const {
+        return hasObstacle(x + 1, z) || hasObstacle(x - 1, z) ||
+            hasObstacle(x, z + 1) || hasObstacle(x, z - 1);
+    }
+
+    // Appends the next path segment, from the streamer when it has it ready
+    void extendPath();
+
+    // Improved version of generateInitialPath() method that only generates path without obstacles
+    void generateInitialPath();
+
+    // Adds a generated chunk's tiles and obstacles and moves pathCursor past it
+    void applyPathChunk(const PathChunk& chunk);
+
+    bool onPath(float x, float z);
+
+    // True if a player cube at (x, y, z) hits an obstacle; hitType, if given, receives its type
+    bool checkObstacleCollision(float x, float y, float z, ObstacleType* hitType = nullptr);
+
+    // Where the player is at the given progress of the current jump or roll:
+    // jumps follow their arc, rolls carry the cube's centre round its bottom edge
+    struct MovePoint {
+        float x, z;
+        float height;  // Above playerY
+    };
+    MovePoint movePoint(float progress) const;
+
+    // Swept collision test for the current jump or roll between two progress
+    // values, the later one reached at game time toTime, with obstacles moving
+    // as they do over that interval. Finds the first contact by conservative
+    // advancement: each step is as long as the gap to the obstacle on the
+    // player's cell (or to the next cell) can be closed at the two's top speeds,
+    // so contacts are found whatever the tick length. On a hit, hitProgress
+    // receives the progress of the contact.
+    bool sweepObstacleCollision(float fromProgress, float toProgress, double toTime, float moveSpeed,
+        float* hitProgress, ObstacleType* hitType = nullptr);
+
+    void updateGame(float deltaTime);
+
+    void reset(uint64_t newSeed);
+
+    // FNV-1a hash of the tiles and obstacles currently in the window, for reproducibility checks
+    uint64_t worldHash() const;
+
+    void nextCameraMode();
+
+    void toggleCameraRotation();
+
+    void zoomIn();
+
+    void zoomOut();
+};
+
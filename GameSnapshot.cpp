@@ -0,0 +1,122 @@
+#include "GameSnapshot.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+static const char SNAPSHOT_MAGIC[4] = { 'C', 'R', 'S', 'S' };
+
+// Every scalar field of Game. Adding state to Game means adding it here and
+// bumping GameSnapshot::VERSION.
+struct ScalarBlock {
+    int32_t score;
+    float playerX, playerY, playerZ;
+    float rollAngle, rollProgress;
+    int32_t rollDirection;
+    int32_t maxDistanceTraveled;
+    float jumpHeight, jumpProgress;
+    float jumpDestX, jumpDestZ, jumpStartX, jumpStartZ;
+    int32_t cameraMode;
+    float cameraDistance, cameraAngle;
+    Game::Tuning tuning;
+    uint64_t seed;
+    PathCursor pathCursor;
+    double time;
+    int32_t deathCause, killedBy;
+    uint8_t isRolling, gameOver, showDirections, isJumping, fixedCameraAngle;
+    uint8_t keyW, keyS, keyA, keyD, keySpace;
+};
+static_assert(std::is_trivially_copyable<ScalarBlock>::value, "the scalar block is copied raw");
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t totalBytes;
+};
+
+void GameSnapshot::capture(const Game& game) {
+    ScalarBlock s;
+    std::memset(static_cast<void*>(&s), 0, sizeof(s));  // Padding too, so equal states give equal bytes
+    s.score = game.score;
+    s.playerX = game.playerX; s.playerY = game.playerY; s.playerZ = game.playerZ;
+    s.rollAngle = game.rollAngle; s.rollProgress = game.rollProgress;
+    s.rollDirection = game.rollDirection;
+    s.maxDistanceTraveled = game.maxDistanceTraveled;
+    s.jumpHeight = game.jumpHeight; s.jumpProgress = game.jumpProgress;
+    s.jumpDestX = game.jumpDestX; s.jumpDestZ = game.jumpDestZ;
+    s.jumpStartX = game.jumpStartX; s.jumpStartZ = game.jumpStartZ;
+    s.cameraMode = game.cameraMode;
+    s.cameraDistance = game.cameraDistance; s.cameraAngle = game.cameraAngle;
+    s.tuning = game.tuning;
+    s.seed = game.seed;
+    s.pathCursor = game.pathCursor;
+    s.time = game.time;
+    s.deathCause = game.deathCause; s.killedBy = game.killedBy;
+    s.isRolling = game.isRolling; s.gameOver = game.gameOver; s.showDirections = game.showDirections;
+    s.isJumping = game.isJumping; s.fixedCameraAngle = game.fixedCameraAngle;
+    s.keyW = game.keyW; s.keyS = game.keyS; s.keyA = game.keyA; s.keyD = game.keyD; s.keySpace = game.keySpace;
+
+    size_t total = sizeof(SnapshotHeader) + sizeof(ScalarBlock) + game.path.imageBytes()
+        + game.obstacles.imageBytes() + game.tileIndex.imageBytes() + game.obstacleGrid.imageBytes();
+    buffer.resize(total);  // Keeps its storage when the size is unchanged or smaller
+
+    SnapshotHeader header = { { SNAPSHOT_MAGIC[0], SNAPSHOT_MAGIC[1], SNAPSHOT_MAGIC[2], SNAPSHOT_MAGIC[3] },
+        VERSION, total };
+    uint8_t* out = buffer.data();
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    std::memcpy(out, &s, sizeof(s));
+    out += sizeof(s);
+    out = game.path.saveImage(out);
+    out = game.obstacles.saveImage(out);
+    out = game.tileIndex.saveImage(out);
+    game.obstacleGrid.saveImage(out);
+}
+
+void GameSnapshot::restore(Game& game) const {
+    SnapshotHeader header;
+    if (buffer.size() < sizeof(header) + sizeof(ScalarBlock)) {
+        throw std::runtime_error("snapshot is empty or truncated");
+    }
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 || header.totalBytes != buffer.size()) {
+        throw std::runtime_error("not a game snapshot");
+    }
+    if (header.version != VERSION) {
+        throw std::runtime_error("unsupported game snapshot version");
+    }
+
+    ScalarBlock s;
+    const uint8_t* in = buffer.data() + sizeof(header);
+    const uint8_t* end = buffer.data() + buffer.size();
+    std::memcpy(&s, in, sizeof(s));
+    in += sizeof(s);
+    in = game.path.loadImage(in, end);
+    if (in) in = game.obstacles.loadImage(in, end);
+    if (in) in = game.tileIndex.loadImage(in, end);
+    if (in) in = game.obstacleGrid.loadImage(in, end);
+    if (in != end) {
+        throw std::runtime_error("corrupt game snapshot");
+    }
+
+    game.score = s.score;
+    game.playerX = s.playerX; game.playerY = s.playerY; game.playerZ = s.playerZ;
+    game.rollAngle = s.rollAngle; game.rollProgress = s.rollProgress;
+    game.rollDirection = s.rollDirection;
+    game.maxDistanceTraveled = s.maxDistanceTraveled;
+    game.jumpHeight = s.jumpHeight; game.jumpProgress = s.jumpProgress;
+    game.jumpDestX = s.jumpDestX; game.jumpDestZ = s.jumpDestZ;
+    game.jumpStartX = s.jumpStartX; game.jumpStartZ = s.jumpStartZ;
+    game.cameraMode = s.cameraMode;
+    game.cameraDistance = s.cameraDistance; game.cameraAngle = s.cameraAngle;
+    game.tuning = s.tuning;
+    game.seed = s.seed;
+    game.pathCursor = s.pathCursor;
+    game.time = s.time;
+    game.deathCause = static_cast<Game::DeathCause>(s.deathCause);
+    game.killedBy = static_cast<Game::ObstacleType>(s.killedBy);
+    game.isRolling = s.isRolling != 0; game.gameOver = s.gameOver != 0; game.showDirections = s.showDirections != 0;
+    game.isJumping = s.isJumping != 0; game.fixedCameraAngle = s.fixedCameraAngle != 0;
+    game.keyW = s.keyW != 0; game.keyS = s.keyS != 0; game.keyA = s.keyA != 0; game.keyD = s.keyD != 0;
+    game.keySpace = s.keySpace != 0;
+}
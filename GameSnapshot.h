@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Game.h"
+
+// Flat binary image of a Game's complete state: player, camera, keys, tuning,
+// RNG, path, obstacles and both cell indexes. The live path tiles and
+// obstacles are copied chunk by chunk and the hash tables as raw arrays, so
+// capture and restore are a handful of memcpys with no rehashing and, once the
+// buffers and chunk pools have reached their size, no allocation. Used for quick save / quick load, replay seeking and search.
+//
+// Layout: "CRSS", uint32 version, uint64 total size, the scalar block, then the
+// images of path, obstacles, tileIndex and obstacleGrid. Images are raw memory,
+// so a snapshot is only valid on the build (and machine type) that wrote it.
+class GameSnapshot {
+public:
+    static constexpr uint32_t VERSION = 4;
+
+    void capture(const Game& game);
+    // Overwrites every field of game; throws std::runtime_error if the
+    // snapshot is empty, from another version or corrupt
+    void restore(Game& game) const;
+
+    bool empty() const { return buffer.empty(); }
+    size_t size() const { return buffer.size(); }
+    const uint8_t* data() const { return buffer.data(); }
+    void assign(const uint8_t* bytes, size_t length) { buffer.assign(bytes, bytes + length); }
+
+private:
+    std::vector<uint8_t> buffer;
+};
@@ -0,0 +1,42 @@
+#include "GpuTimer.h"
+
+bool GpuTimer::init() {
+    if (!glExt.hasTimerQueries) return false;
+    for (Frame& frame : frames) {
+        glExt.GenQueries(SPANS_PER_FRAME, frame.queries);
+    }
+    initialized = true;
+    return true;
+}
+
+void GpuTimer::beginFrame() {
+    if (!initialized) return;
+    end();
+    current = (current + 1) % FRAMES_IN_FLIGHT;
+
+    // This frame slot was last used FRAMES_IN_FLIGHT - 1 frames ago
+    Frame& frame = frames[current];
+    for (int i = 0; i < frame.count; ++i) {
+        GLuint64 elapsed = 0;
+        glExt.GetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &elapsed);
+        profiler.record(frame.spans[i].phase, true, frame.spans[i].submittedNs, elapsed);
+    }
+    frame.count = 0;
+}
+
+void GpuTimer::begin(ProfilePhase phase) {
+    if (!initialized) return;
+    end();
+    Frame& frame = frames[current];
+    if (frame.count == SPANS_PER_FRAME) return;
+    frame.spans[frame.count] = { phase, Profiler::nowNs() };
+    glExt.BeginQuery(GL_TIME_ELAPSED, frame.queries[frame.count]);
+    spanOpen = true;
+}
+
+void GpuTimer::end() {
+    if (!spanOpen) return;
+    glExt.EndQuery(GL_TIME_ELAPSED);
+    frames[current].count++;
+    spanOpen = false;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GLExtensions.h"
+#include "Profiler.h"
+
+// GPU time of frame phases, measured with GL_TIME_ELAPSED queries and handed
+// to the profiler a few frames later, once the results are in, so reading them
+// never stalls the pipeline. Elapsed-time queries cannot nest: begin() closes
+// the open span before starting the next one. Does nothing unless init()
+// found timer queries (GL 3.3 or ARB_timer_query).
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    bool init();
+    bool ready() const { return initialized; }
+
+    // Collects the results of the oldest frame in flight and starts a new frame
+    void beginFrame();
+    void begin(ProfilePhase phase);
+    void end();
+
+private:
+    static constexpr int FRAMES_IN_FLIGHT = 4;
+    static constexpr int SPANS_PER_FRAME = 64;  // Further spans of a frame are dropped
+
+    struct Span {
+        ProfilePhase phase;
+        uint64_t submittedNs;
+    };
+
+    struct Frame {
+        GLuint queries[SPANS_PER_FRAME] = {};
+        Span spans[SPANS_PER_FRAME];
+        int count = 0;
+    };
+
+    bool initialized = false;
+    Frame frames[FRAMES_IN_FLIGHT];
+    int current = 0;
+    bool spanOpen = false;
+};
@@ -0,0 +1,245 @@
+#include "HudText.h"
+
+#include <GL/glut.h>
+#ifdef FREEGLUT
+#include <GL/freeglut_ext.h>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+bool HudText::init(void* glutFont) {
+    if (!glExt.hasBuffers || !glExt.hasFramebuffers) {
+        std::cerr << "HUD text atlas needs buffer and framebuffer objects; using bitmap text" << std::endl;
+        return false;
+    }
+
+#ifdef FREEGLUT
+    cellHeight = glutBitmapHeight(glutFont) + 2;
+#else
+    cellHeight = 26;
+#endif
+    baseline = cellHeight / 4;
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        cellWidth = std::max(cellWidth, glutBitmapWidth(glutFont, FIRST_GLYPH + i) + 2);
+    }
+    // One extra cell after the glyphs holds the solid texel used for rectangles
+    int rows = (GLYPH_COUNT + 1 + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    int width = ATLAS_COLUMNS * cellWidth, height = rows * cellHeight;
+
+    // The caller may itself be rendering into a framebuffer object; put it back afterwards
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    GLuint texture = 0, framebuffer = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glExt.GenFramebuffers(1, &framebuffer);
+    glExt.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glExt.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    bool complete = glExt.CheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    std::vector<uint8_t> coverage;
+    if (complete) {
+        // Let GLUT draw every glyph into its cell, white on black
+        glPushAttrib(GL_ALL_ATTRIB_BITS);
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glOrtho(0, width, 0, height, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        glViewport(0, 0, width, height);
+        glDisable(GL_LIGHTING);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_FOG);
+        glDisable(GL_BLEND);
+        glDisable(GL_TEXTURE_2D);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glColor3f(1.0f, 1.0f, 1.0f);
+        for (int i = 0; i < GLYPH_COUNT; ++i) {
+            glRasterPos2i((i % ATLAS_COLUMNS) * cellWidth + 1, (i / ATLAS_COLUMNS) * cellHeight + baseline);
+            glutBitmapCharacter(glutFont, FIRST_GLYPH + i);
+        }
+        int solid = GLYPH_COUNT;
+        glRecti((solid % ATLAS_COLUMNS) * cellWidth, (solid / ATLAS_COLUMNS) * cellHeight,
+            (solid % ATLAS_COLUMNS) * cellWidth + 2, (solid / ATLAS_COLUMNS) * cellHeight + 2);
+
+        coverage.resize(static_cast<size_t>(width) * height);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, coverage.data());
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+        glPopAttrib();
+    }
+    glExt.BindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glExt.DeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+    if (!complete) {
+        std::cerr << "HUD text atlas framebuffer incomplete; using bitmap text" << std::endl;
+        return false;
+    }
+
+    // The captured coverage becomes an alpha texture; vertex colors tint it
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, coverage.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        float x = static_cast<float>((i % ATLAS_COLUMNS) * cellWidth);
+        float y = static_cast<float>((i / ATLAS_COLUMNS) * cellHeight);
+        glyphs[i] = { x / width, y / height, (x + cellWidth) / width, (y + cellHeight) / height,
+            glutBitmapWidth(glutFont, FIRST_GLYPH + i) };
+    }
+    solidU = ((GLYPH_COUNT % ATLAS_COLUMNS) * cellWidth + 1.0f) / width;
+    solidV = ((GLYPH_COUNT / ATLAS_COLUMNS) * cellHeight + 1.0f) / height;
+
+    glExt.GenBuffers(1, &vertexBuffer);
+    return true;
+}
+
+int HudText::addRect(float x0, float y0, float x1, float y1, const float* rgba) {
+    Field field;
+    field.firstVertex = vertices.size();
+    field.vertexCount = 4;
+    field.x = x0;
+    field.y = y0;
+    for (int c = 0; c < 4; ++c) field.color[c] = static_cast<uint8_t>(rgba[c] * 255.0f + 0.5f);
+    field.isText = false;
+    field.visible = true;
+
+    Vertex corner = { 0, 0, solidU, solidV, field.color[0], field.color[1], field.color[2], field.color[3] };
+    const float xs[] = { x0, x1, x1, x0 }, ys[] = { y0, y0, y1, y1 };
+    for (int i = 0; i < 4; ++i) {
+        corner.x = xs[i];
+        corner.y = ys[i];
+        vertices.push_back(corner);
+    }
+    fields.push_back(std::move(field));
+    markDirty(fields.back());
+    return static_cast<int>(fields.size()) - 1;
+}
+
+int HudText::addText(float x, float y, const float* rgb, size_t capacity, const char* text) {
+    Field field;
+    field.firstVertex = vertices.size();
+    field.vertexCount = capacity * 4;
+    field.x = x;
+    field.y = y;
+    for (int c = 0; c < 3; ++c) field.color[c] = static_cast<uint8_t>(rgb[c] * 255.0f + 0.5f);
+    field.color[3] = 255;
+    field.isText = true;
+    field.visible = true;
+    field.text.reserve(capacity);
+    field.text.assign(text, std::min(std::strlen(text), capacity));
+
+    vertices.resize(vertices.size() + field.vertexCount);
+    fields.push_back(std::move(field));
+    rebuild(fields.back());
+    return static_cast<int>(fields.size()) - 1;
+}
+
+void HudText::setText(int field, const char* text) {
+    Field& f = fields[field];
+    size_t length = std::min(std::strlen(text), f.vertexCount / 4);
+    if (f.text.size() == length && f.text.compare(0, length, text, length) == 0) return;
+    f.text.assign(text, length);
+    rebuild(f);
+}
+
+void HudText::setVisible(int field, bool visible) {
+    Field& f = fields[field];
+    if (f.visible == visible) return;
+    f.visible = visible;
+    rebuild(f);
+}
+
+void HudText::rebuild(Field& field) {
+    Vertex* out = &vertices[field.firstVertex];
+    if (!field.isText) {
+        for (size_t i = 0; i < 4; ++i) out[i].a = field.visible ? field.color[3] : 0;
+        markDirty(field);
+        return;
+    }
+
+    // Unused character slots collapse to zero-area quads at the origin
+    std::memset(out, 0, field.vertexCount * sizeof(Vertex));
+    if (field.visible) {
+        float penX = field.x;
+        float y0 = field.y - baseline, y1 = y0 + cellHeight;
+        for (char c : field.text) {
+            int index = static_cast<unsigned char>(c) - FIRST_GLYPH;
+            if (index < 0 || index >= GLYPH_COUNT) index = 0;
+            const Glyph& g = glyphs[index];
+            float x0 = penX - 1.0f, x1 = x0 + cellWidth;
+            const float xs[] = { x0, x1, x1, x0 }, ys[] = { y0, y0, y1, y1 };
+            const float us[] = { g.u0, g.u1, g.u1, g.u0 }, vs[] = { g.v0, g.v0, g.v1, g.v1 };
+            for (int i = 0; i < 4; ++i) {
+                *out++ = { xs[i], ys[i], us[i], vs[i], field.color[0], field.color[1], field.color[2], field.color[3] };
+            }
+            penX += g.advance;
+        }
+    }
+    markDirty(field);
+}
+
+void HudText::markDirty(const Field& field) {
+    size_t begin = field.firstVertex, end = field.firstVertex + field.vertexCount;
+    if (dirtyBegin == dirtyEnd) {
+        dirtyBegin = begin;
+        dirtyEnd = end;
+    }
+    else {
+        dirtyBegin = std::min(dirtyBegin, begin);
+        dirtyEnd = std::max(dirtyEnd, end);
+    }
+}
+
+void HudText::draw() {
+    if (!ready() || vertices.empty()) return;
+
+    glExt.BindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    if (bufferVertices != vertices.size()) {
+        glExt.BufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_DYNAMIC_DRAW);
+        bufferVertices = vertices.size();
+    }
+    else if (dirtyBegin != dirtyEnd) {
+        glExt.BufferSubData(GL_ARRAY_BUFFER, dirtyBegin * sizeof(Vertex), (dirtyEnd - dirtyBegin) * sizeof(Vertex),
+            &vertices[dirtyBegin]);
+    }
+    dirtyBegin = dirtyEnd = 0;
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(offsetof(Vertex, x)));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(offsetof(Vertex, u)));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(offsetof(Vertex, r)));
+
+    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(vertices.size()));
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    glExt.BindBuffer(GL_ARRAY_BUFFER, 0);
+}
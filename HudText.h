@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GLExtensions.h"
+
+// Heads-up display drawn from a glyph atlas. The GLUT bitmap font is rasterized
+// once into a texture; every HUD element owns a fixed range of one vertex
+// buffer, so the whole HUD goes out in a single draw call and a text field is
+// only rebuilt (and re-uploaded) when its contents change. Nothing is
+// allocated after the fields have been added.
+class HudText {
+public:
+    // Captures the font's printable ASCII glyphs. Needs GLUT, framebuffer and
+    // buffer objects; returns false (and draws nothing) without them.
+    bool init(void* glutFont);
+    bool ready() const { return atlasTexture != 0; }
+
+    // Elements, in HUD coordinates (the 800 x 600 orthographic space). Both
+    // return a handle for setText / setVisible.
+    int addRect(float x0, float y0, float x1, float y1, const float* rgba);
+    int addText(float x, float y, const float* rgb, size_t capacity, const char* text = "");
+
+    // Truncated to the field's capacity; a no-op when the text is unchanged
+    void setText(int field, const char* text);
+    void setVisible(int field, bool visible);
+
+    // Draws every visible element. Expects the HUD projection to be current.
+    void draw();
+
+private:
+    struct Vertex {
+        float x, y, u, v;
+        uint8_t r, g, b, a;
+    };
+
+    struct Glyph {
+        float u0, v0, u1, v1;
+        int advance;
+    };
+
+    struct Field {
+        size_t firstVertex, vertexCount;  // Four vertices per character or rectangle
+        float x, y;
+        uint8_t color[4];
+        bool isText, visible;
+        std::string text;                 // Reserved to capacity up front
+    };
+
+    static constexpr int FIRST_GLYPH = 32, GLYPH_COUNT = 95;
+    static constexpr int ATLAS_COLUMNS = 16;
+
+    GLuint atlasTexture = 0;
+    GLuint vertexBuffer = 0;
+    size_t bufferVertices = 0;  // Vertices the buffer was allocated for
+    int cellWidth = 0, cellHeight = 0, baseline = 0;
+    Glyph glyphs[GLYPH_COUNT] = {};
+    float solidU = 0.0f, solidV = 0.0f;  // A fully covered texel, for rectangles
+
+    std::vector<Field> fields;
+    std::vector<Vertex> vertices;
+    size_t dirtyBegin = 0, dirtyEnd = 0;
+
+    void rebuild(Field& field);
+    void markDirty(const Field& field);
+};
@@ -0,0 +1,139 @@
+#include "Meshes.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void addVertex(MeshData& mesh, float x, float y, float z, float nx, float ny, float nz) {
+    mesh.vertices.insert(mesh.vertices.end(), { x, y, z, nx, ny, nz });
+}
+
+MeshData makeSolidCube(float size) {
+    // Per face: the normal and two axes spanning it, with u x v = normal so quads wind
+    // counter-clockwise seen from outside
+    static const float faces[6][3][3] = {
+        { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },
+        { { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },
+        { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } },
+        { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },
+        { { 0, 0, 1 }, { 1, 0, 0 }, { 0, 1, 0 } },
+        { { 0, 0, -1 }, { 0, 1, 0 }, { 1, 0, 0 } },
+    };
+    static const float corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+    float h = size * 0.5f;
+
+    MeshData mesh;
+    mesh.hasNormals = true;
+    for (const auto& face : faces) {
+        const float* n = face[0];
+        const float* u = face[1];
+        const float* v = face[2];
+        uint32_t base = static_cast<uint32_t>(mesh.vertexCount());
+        for (const auto& c : corners) {
+            addVertex(mesh,
+                h * (n[0] + c[0] * u[0] + c[1] * v[0]),
+                h * (n[1] + c[0] * u[1] + c[1] * v[1]),
+                h * (n[2] + c[0] * u[2] + c[1] * v[2]),
+                n[0], n[1], n[2]);
+        }
+        mesh.indices.insert(mesh.indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+    }
+    return mesh;
+}
+
+MeshData makeWireCube(float size) {
+    float h = size * 0.5f;
+    MeshData mesh;
+    mesh.primitive = MeshData::LINES;
+    for (int corner = 0; corner < 8; ++corner) {
+        mesh.vertices.insert(mesh.vertices.end(), {
+            (corner & 1) ? h : -h, (corner & 2) ? h : -h, (corner & 4) ? h : -h });
+    }
+    // Edges join corners that differ in exactly one coordinate
+    for (uint32_t a = 0; a < 8; ++a) {
+        for (uint32_t bit = 1; bit < 8; bit <<= 1) {
+            if (!(a & bit)) mesh.indices.insert(mesh.indices.end(), { a, a | bit });
+        }
+    }
+    return mesh;
+}
+
+MeshData makeSphere(float radius, int slices, int stacks) {
+    MeshData mesh;
+    mesh.hasNormals = true;
+    for (int stack = 0; stack <= stacks; ++stack) {
+        float phi = static_cast<float>(M_PI) * stack / stacks;
+        for (int slice = 0; slice <= slices; ++slice) {
+            float theta = 2.0f * static_cast<float>(M_PI) * slice / slices;
+            float nx = std::sin(phi) * std::cos(theta);
+            float ny = std::sin(phi) * std::sin(theta);
+            float nz = std::cos(phi);
+            addVertex(mesh, radius * nx, radius * ny, radius * nz, nx, ny, nz);
+        }
+    }
+    uint32_t row = slices + 1;
+    for (int stack = 0; stack < stacks; ++stack) {
+        for (int slice = 0; slice < slices; ++slice) {
+            uint32_t a = stack * row + slice, b = a + row;
+            mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+    return mesh;
+}
+
+MeshData makeCone(float base, float height, int slices, int stacks) {
+    MeshData mesh;
+    mesh.hasNormals = true;
+
+    // Side normals lean outwards by the cone's slope
+    float slant = std::sqrt(height * height + base * base);
+    float nr = height / slant, nz = base / slant;
+    for (int stack = 0; stack <= stacks; ++stack) {
+        float z = height * stack / stacks;
+        float r = base * (1.0f - static_cast<float>(stack) / stacks);
+        for (int slice = 0; slice <= slices; ++slice) {
+            float theta = 2.0f * static_cast<float>(M_PI) * slice / slices;
+            float c = std::cos(theta), s = std::sin(theta);
+            addVertex(mesh, r * c, r * s, z, nr * c, nr * s, nz);
+        }
+    }
+    uint32_t row = slices + 1;
+    for (int stack = 0; stack < stacks; ++stack) {
+        for (int slice = 0; slice < slices; ++slice) {
+            uint32_t a = stack * row + slice, b = a + row;
+            mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+
+    // Base disk facing -z
+    uint32_t center = static_cast<uint32_t>(mesh.vertexCount());
+    addVertex(mesh, 0, 0, 0, 0, 0, -1);
+    for (int slice = 0; slice <= slices; ++slice) {
+        float theta = 2.0f * static_cast<float>(M_PI) * slice / slices;
+        addVertex(mesh, base * std::cos(theta), base * std::sin(theta), 0, 0, 0, -1);
+    }
+    for (int slice = 0; slice < slices; ++slice) {
+        mesh.indices.insert(mesh.indices.end(), { center, center + 2 + slice, center + 1 + slice });
+    }
+    return mesh;
+}
+
+MeshData makeGrid(int halfExtent, float y) {
+    MeshData mesh;
+    mesh.primitive = MeshData::LINES;
+    mesh.hasColors = true;
+    float e = static_cast<float>(halfExtent);
+    for (int i = -halfExtent; i <= halfExtent; i++) {
+        float shade = 0.3f * (1.0f - (std::abs(i) / e));
+        float f = static_cast<float>(i);
+        mesh.vertices.insert(mesh.vertices.end(), {
+            f, y, -e, shade, shade, shade,
+            f, y, e, shade, shade, shade,
+            -e, y, f, shade, shade, shade,
+            e, y, f, shade, shade, shade });
+    }
+    return mesh;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// CPU-side geometry for the shapes the scene is built from, generated once and
+// uploaded by the retained renderer. Tessellations match the GLUT shapes the
+// immediate renderer draws, so both backends show the same scene.
+struct MeshData {
+    enum Primitive { TRIANGLES, LINES };
+
+    Primitive primitive = TRIANGLES;
+    bool hasNormals = false;
+    bool hasColors = false;
+    std::vector<float> vertices;    // Interleaved position (3), then normal (3), then color (3)
+    std::vector<uint32_t> indices;  // Empty for non-indexed meshes
+
+    int floatsPerVertex() const { return 3 + (hasNormals ? 3 : 0) + (hasColors ? 3 : 0); }
+    int vertexCount() const { return static_cast<int>(vertices.size()) / floatsPerVertex(); }
+};
+
+// Axis-aligned cube centred on the origin, as glutSolidCube
+MeshData makeSolidCube(float size);
+
+// The 12 edges of a cube, as glutWireCube
+MeshData makeWireCube(float size);
+
+// UV sphere around the origin, as glutSolidSphere
+MeshData makeSphere(float radius, int slices, int stacks);
+
+// Cone along +z with its base at z = 0, as glutSolidCone
+MeshData makeCone(float base, float height, int slices, int stacks);
+
+// Ground grid of lines from -halfExtent to halfExtent at height y, fading out towards the edges
+MeshData makeGrid(int halfExtent, float y);
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ObstacleTraits.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CROSSY_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Batch evaluation of obstacle poses for drawing. Obstacles of one type are
+// packed into an ObstacleBucket (parallel x / z / age arrays), and one kernel
+// per type fills in the pose arrays with its trait's pose (ObstacleTraits.h),
+// but with a polynomial sin/cos (max error about 4e-6, well inside 1e-4) so the
+// loops vectorize. The simulation itself poses obstacles with
+// ExactObstacleMath, so results never depend on the CPU.
+
+// Packed obstacles of one type; the caller fills x, z and age, a kernel the rest
+struct ObstacleBucket {
+    std::vector<int32_t> x, z;
+    std::vector<float> age;
+    std::vector<float> height, rotation, offsetX, offsetZ;
+
+    size_t size() const { return age.size(); }
+
+    void clear() {
+        x.clear();
+        z.clear();
+        age.clear();
+    }
+
+    void push_back(int32_t cellX, int32_t cellZ, float obstacleAge) {
+        x.push_back(cellX);
+        z.push_back(cellZ);
+        age.push_back(obstacleAge);
+    }
+
+    // Sizes the pose arrays to match; keeps their storage across frames
+    void preparePoses() {
+        height.resize(age.size());
+        rotation.resize(age.size());
+        offsetX.resize(age.size());
+        offsetZ.resize(age.size());
+    }
+};
+
+using ObstacleKernel = void (*)(ObstacleBucket& bucket, size_t start);
+
+// Cody-Waite reduction to r in [-pi/4, pi/4] plus quadrant; PIO2_HI has few
+// enough bits that k * PIO2_HI is exact for |x| up to about 1e5
+static constexpr float OBSTACLE_TWO_OVER_PI = 0.636619772f;
+static constexpr float OBSTACLE_PIO2_HI = 1.5703125f;
+static constexpr float OBSTACLE_PIO2_LO = 4.83826794896e-4f;
+
+inline void fastSinCos(float x, float& sinOut, float& cosOut) {
+    float k = std::nearbyint(x * OBSTACLE_TWO_OVER_PI);
+    int32_t q = static_cast<int32_t>(k);
+    float r = x - k * OBSTACLE_PIO2_HI;
+    r = r - k * OBSTACLE_PIO2_LO;
+    float r2 = r * r;
+    float s = r + r * r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f)));
+    float c = 1.0f + r2 * (-0.5f + r2 * (1.0f / 24.0f + r2 * (-1.0f / 720.0f)));
+    float sinR = (q & 1) ? c : s;
+    float cosR = (q & 1) ? s : c;
+    sinOut = (q & 2) ? -sinR : sinR;
+    cosOut = ((q + 1) & 2) ? -cosR : cosR;
+}
+
+// Game::obstaclePose rotation, without the division of fmod; ages are never negative
+inline float wrapDegrees(float degrees) {
+    return degrees - static_cast<float>(static_cast<int32_t>(degrees * (1.0f / 360.0f))) * 360.0f;
+}
+
+struct FastObstacleMath {
+    static void sinCos(float x, float& sinOut, float& cosOut) { fastSinCos(x, sinOut, cosOut); }
+    static float wrapDegrees(float degrees) { return ::wrapDegrees(degrees); }
+};
+
+// Each kernel handles elements [start, size) so the SIMD ones can finish with
+// the scalar loop, which is the trait's pose inlined into a loop over the bucket
+template <typename Trait>
+inline void posesScalar(ObstacleBucket& b, size_t start) {
+    for (size_t i = start; i < b.size(); ++i) {
+        ObstaclePose pose = Trait::template pose<FastObstacleMath>(b.age[i]);
+        b.height[i] = pose.height;
+        b.rotation[i] = pose.rotation;
+        b.offsetX[i] = pose.offsetX;
+        b.offsetZ[i] = pose.offsetZ;
+    }
+}
+
+#ifdef CROSSY_X86_SIMD
+__attribute__((target("sse2")))
+inline void fastSinCosSSE2(__m128 x, __m128& sinOut, __m128& cosOut) {
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(OBSTACLE_TWO_OVER_PI)));  // Round to nearest
+    __m128 k = _mm_cvtepi32_ps(q);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(OBSTACLE_PIO2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(OBSTACLE_PIO2_LO)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 sp = _mm_add_ps(_mm_set1_ps(1.0f / 120.0f), _mm_mul_ps(r2, _mm_set1_ps(-1.0f / 5040.0f)));
+    sp = _mm_add_ps(_mm_set1_ps(-1.0f / 6.0f), _mm_mul_ps(r2, sp));
+    __m128 s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), sp));
+    __m128 cp = _mm_add_ps(_mm_set1_ps(1.0f / 24.0f), _mm_mul_ps(r2, _mm_set1_ps(-1.0f / 720.0f)));
+    cp = _mm_add_ps(_mm_set1_ps(-0.5f), _mm_mul_ps(r2, cp));
+    __m128 c = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, cp));
+
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sinR = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+    __m128 cosR = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+    // Bit 1 of the quadrant (of q + 1 for cos) moved up to the sign bit
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+    sinOut = _mm_xor_ps(sinR, sinSign);
+    cosOut = _mm_xor_ps(cosR, cosSign);
+}
+
+__attribute__((target("sse2")))
+inline void risingPosesSSE2(ObstacleBucket& b, size_t start) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t i = start;
+    for (; i + 4 <= b.size(); i += 4) {
+        __m128 age = _mm_loadu_ps(&b.age[i]);
+        _mm_storeu_ps(&b.height[i], _mm_min_ps(_mm_set1_ps(RisingBlock::TOP), _mm_mul_ps(age, _mm_set1_ps(RisingBlock::RISE_SPEED))));
+        _mm_storeu_ps(&b.rotation[i], zero);
+        _mm_storeu_ps(&b.offsetX[i], zero);
+        _mm_storeu_ps(&b.offsetZ[i], zero);
+    }
+    posesScalar<RisingBlock>(b, i);
+}
+
+__attribute__((target("sse2")))
+inline void fallingPosesSSE2(ObstacleBucket& b, size_t start) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 top = _mm_set1_ps(FallingBlock::START_HEIGHT);
+    const __m128 fallRate = _mm_set1_ps(FallingBlock::START_HEIGHT / FallingBlock::FALL_TIME);
+    size_t i = start;
+    for (; i + 4 <= b.size(); i += 4) {
+        __m128 age = _mm_loadu_ps(&b.age[i]);
+        __m128 height = _mm_sub_ps(top, _mm_mul_ps(age, fallRate));
+        _mm_storeu_ps(&b.height[i], _mm_max_ps(zero, height));
+        _mm_storeu_ps(&b.rotation[i], zero);
+        _mm_storeu_ps(&b.offsetX[i], zero);
+        _mm_storeu_ps(&b.offsetZ[i], zero);
+    }
+    posesScalar<FallingBlock>(b, i);
+}
+
+__attribute__((target("sse2")))
+inline void spinningPosesSSE2(ObstacleBucket& b, size_t start) {
+    const __m128 zero = _mm_setzero_ps();
+    size_t i = start;
+    for (; i + 4 <= b.size(); i += 4) {
+        __m128 age = _mm_loadu_ps(&b.age[i]);
+        __m128 s, c;
+        fastSinCosSSE2(_mm_mul_ps(age, _mm_set1_ps(SpinningBlock::BOB_RATE)), s, c);
+        _mm_storeu_ps(&b.height[i], _mm_add_ps(_mm_set1_ps(SpinningBlock::BOB_CENTER),
+            _mm_mul_ps(_mm_set1_ps(SpinningBlock::BOB_AMPLITUDE), s)));
+        __m128 degrees = _mm_mul_ps(age, _mm_set1_ps(SpinningBlock::SPIN_SPEED));
+        __m128 turns = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(degrees, _mm_set1_ps(1.0f / 360.0f))));
+        _mm_storeu_ps(&b.rotation[i], _mm_sub_ps(degrees, _mm_mul_ps(turns, _mm_set1_ps(360.0f))));
+        _mm_storeu_ps(&b.offsetX[i], zero);
+        _mm_storeu_ps(&b.offsetZ[i], zero);
+    }
+    posesScalar<SpinningBlock>(b, i);
+}
+
+__attribute__((target("sse2")))
+inline void movingPosesSSE2(ObstacleBucket& b, size_t start) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 radius = _mm_set1_ps(MovingBlock::ORBIT_RADIUS);
+    size_t i = start;
+    for (; i + 4 <= b.size(); i += 4) {
+        __m128 s, c;
+        fastSinCosSSE2(_mm_mul_ps(_mm_loadu_ps(&b.age[i]), _mm_set1_ps(MovingBlock::ORBIT_RATE)), s, c);
+        _mm_storeu_ps(&b.offsetX[i], _mm_mul_ps(radius, s));
+        _mm_storeu_ps(&b.offsetZ[i], _mm_mul_ps(radius, c));
+        _mm_storeu_ps(&b.height[i], zero);
+        _mm_storeu_ps(&b.rotation[i], zero);
+    }
+    posesScalar<MovingBlock>(b, i);
+}
+
+__attribute__((target("avx2")))
+inline void fastSinCosAVX2(__m256 x, __m256& sinOut, __m256& cosOut) {
+    __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(OBSTACLE_TWO_OVER_PI)));
+    __m256 k = _mm256_cvtepi32_ps(q);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(k, _mm256_set1_ps(OBSTACLE_PIO2_HI)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(k, _mm256_set1_ps(OBSTACLE_PIO2_LO)));
+    __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 sp = _mm256_add_ps(_mm256_set1_ps(1.0f / 120.0f), _mm256_mul_ps(r2, _mm256_set1_ps(-1.0f / 5040.0f)));
+    sp = _mm256_add_ps(_mm256_set1_ps(-1.0f / 6.0f), _mm256_mul_ps(r2, sp));
+    __m256 s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), sp));
+    __m256 cp = _mm256_add_ps(_mm256_set1_ps(1.0f / 24.0f), _mm256_mul_ps(r2, _mm256_set1_ps(-1.0f / 720.0f)));
+    cp = _mm256_add_ps(_mm256_set1_ps(-0.5f), _mm256_mul_ps(r2, cp));
+    __m256 c = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(r2, cp));
+
+    const __m256i one = _mm256_set1_epi32(1), two = _mm256_set1_epi32(2);
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    __m256 sinR = _mm256_blendv_ps(s, c, swap);
+    __m256 cosR = _mm256_blendv_ps(c, s, swap);
+    __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30));
+    sinOut = _mm256_xor_ps(sinR, sinSign);
+    cosOut = _mm256_xor_ps(cosR, cosSign);
+}
+
+__attribute__((target("avx2")))
+inline void risingPosesAVX2(ObstacleBucket& b, size_t start) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t i = start;
+    for (; i + 8 <= b.size(); i += 8) {
+        __m256 age = _mm256_loadu_ps(&b.age[i]);
+        _mm256_storeu_ps(&b.height[i], _mm256_min_ps(_mm256_set1_ps(RisingBlock::TOP),
+            _mm256_mul_ps(age, _mm256_set1_ps(RisingBlock::RISE_SPEED))));
+        _mm256_storeu_ps(&b.rotation[i], zero);
+        _mm256_storeu_ps(&b.offsetX[i], zero);
+        _mm256_storeu_ps(&b.offsetZ[i], zero);
+    }
+    risingPosesSSE2(b, i);
+}
+
+__attribute__((target("avx2")))
+inline void fallingPosesAVX2(ObstacleBucket& b, size_t start) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 top = _mm256_set1_ps(FallingBlock::START_HEIGHT);
+    const __m256 fallRate = _mm256_set1_ps(FallingBlock::START_HEIGHT / FallingBlock::FALL_TIME);
+    size_t i = start;
+    for (; i + 8 <= b.size(); i += 8) {
+        __m256 age = _mm256_loadu_ps(&b.age[i]);
+        __m256 height = _mm256_sub_ps(top, _mm256_mul_ps(age, fallRate));
+        _mm256_storeu_ps(&b.height[i], _mm256_max_ps(zero, height));
+        _mm256_storeu_ps(&b.rotation[i], zero);
+        _mm256_storeu_ps(&b.offsetX[i], zero);
+        _mm256_storeu_ps(&b.offsetZ[i], zero);
+    }
+    fallingPosesSSE2(b, i);
+}
+
+__attribute__((target("avx2")))
+inline void spinningPosesAVX2(ObstacleBucket& b, size_t start) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t i = start;
+    for (; i + 8 <= b.size(); i += 8) {
+        __m256 age = _mm256_loadu_ps(&b.age[i]);
+        __m256 s, c;
+        fastSinCosAVX2(_mm256_mul_ps(age, _mm256_set1_ps(SpinningBlock::BOB_RATE)), s, c);
+        _mm256_storeu_ps(&b.height[i], _mm256_add_ps(_mm256_set1_ps(SpinningBlock::BOB_CENTER),
+            _mm256_mul_ps(_mm256_set1_ps(SpinningBlock::BOB_AMPLITUDE), s)));
+        __m256 degrees = _mm256_mul_ps(age, _mm256_set1_ps(SpinningBlock::SPIN_SPEED));
+        __m256 turns = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_mul_ps(degrees, _mm256_set1_ps(1.0f / 360.0f))));
+        _mm256_storeu_ps(&b.rotation[i], _mm256_sub_ps(degrees, _mm256_mul_ps(turns, _mm256_set1_ps(360.0f))));
+        _mm256_storeu_ps(&b.offsetX[i], zero);
+        _mm256_storeu_ps(&b.offsetZ[i], zero);
+    }
+    spinningPosesSSE2(b, i);
+}
+
+__attribute__((target("avx2")))
+inline void movingPosesAVX2(ObstacleBucket& b, size_t start) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 radius = _mm256_set1_ps(MovingBlock::ORBIT_RADIUS);
+    size_t i = start;
+    for (; i + 8 <= b.size(); i += 8) {
+        __m256 s, c;
+        fastSinCosAVX2(_mm256_mul_ps(_mm256_loadu_ps(&b.age[i]), _mm256_set1_ps(MovingBlock::ORBIT_RATE)), s, c);
+        _mm256_storeu_ps(&b.offsetX[i], _mm256_mul_ps(radius, s));
+        _mm256_storeu_ps(&b.offsetZ[i], _mm256_mul_ps(radius, c));
+        _mm256_storeu_ps(&b.height[i], zero);
+        _mm256_storeu_ps(&b.rotation[i], zero);
+    }
+    movingPosesSSE2(b, i);
+}
+#endif
+
+// One kernel per obstacle type, indexed by Game::ObstacleType - 1
+struct ObstacleKernelSet {
+    const char* name;
+    ObstacleKernel kernels[ObstacleTypes::COUNT];
+};
+
+// Kernels per trait: each trait's pose inlined into its own loop, or a
+// hand-vectorized version where one is specialized below. A new obstacle type
+// gets the generic loop without touching this file.
+template <typename Trait>
+struct ObstacleKernelsFor {
+    static constexpr ObstacleKernel SCALAR = posesScalar<Trait>;
+    static constexpr ObstacleKernel SSE2 = posesScalar<Trait>;
+    static constexpr ObstacleKernel AVX2 = posesScalar<Trait>;
+};
+
+#ifdef CROSSY_X86_SIMD
+#define CROSSY_OBSTACLE_SIMD_KERNELS(Trait, prefix) \
+    template <> \
+    struct ObstacleKernelsFor<Trait> { \
+        static constexpr ObstacleKernel SCALAR = posesScalar<Trait>; \
+        static constexpr ObstacleKernel SSE2 = prefix##PosesSSE2; \
+        static constexpr ObstacleKernel AVX2 = prefix##PosesAVX2; \
+    };
+CROSSY_OBSTACLE_SIMD_KERNELS(RisingBlock, rising)
+CROSSY_OBSTACLE_SIMD_KERNELS(FallingBlock, falling)
+CROSSY_OBSTACLE_SIMD_KERNELS(SpinningBlock, spinning)
+CROSSY_OBSTACLE_SIMD_KERNELS(MovingBlock, moving)
+#undef CROSSY_OBSTACLE_SIMD_KERNELS
+#endif
+
+template <typename... Traits>
+constexpr ObstacleKernelSet scalarObstacleKernels(ObstacleTypeList<Traits...>) {
+    return { "scalar", { ObstacleKernelsFor<Traits>::SCALAR... } };
+}
+
+static const ObstacleKernelSet OBSTACLE_KERNELS_SCALAR = scalarObstacleKernels(ObstacleTypes());
+#ifdef CROSSY_X86_SIMD
+template <typename... Traits>
+constexpr ObstacleKernelSet sse2ObstacleKernels(ObstacleTypeList<Traits...>) {
+    return { "sse2", { ObstacleKernelsFor<Traits>::SSE2... } };
+}
+
+template <typename... Traits>
+constexpr ObstacleKernelSet avx2ObstacleKernels(ObstacleTypeList<Traits...>) {
+    return { "avx2", { ObstacleKernelsFor<Traits>::AVX2... } };
+}
+
+static const ObstacleKernelSet OBSTACLE_KERNELS_SSE2 = sse2ObstacleKernels(ObstacleTypes());
+static const ObstacleKernelSet OBSTACLE_KERNELS_AVX2 = avx2ObstacleKernels(ObstacleTypes());
+#endif
+
+// Picks the widest kernels the CPU supports, falling back to the scalar loops
+inline const ObstacleKernelSet& selectObstacleKernels() {
+#ifdef CROSSY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return OBSTACLE_KERNELS_AVX2;
+    if (__builtin_cpu_supports("sse2")) return OBSTACLE_KERNELS_SSE2;
+#endif
+    return OBSTACLE_KERNELS_SCALAR;
+}
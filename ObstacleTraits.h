@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Obstacle behaviours as compile-time traits. Each obstacle type is one struct
+// holding its constants and:
+//   TYPE                        its Game::ObstacleType value, which is its
+//                               position in ObstacleTypes counting from 1
+//   NAME                        for reports
+//   MOTION_RADIUS               furthest its centre gets from (x, 1, z), for culling
+//   pose<Math>(age)             its motion, as a function of seconds since it spawned
+//   separation(pose, cellX, cellZ, x, y, z)
+//                               how far a player cube at (x, y, z) is from colliding
+//                               with it, measured along the axis it is furthest off
+//                               on; zero or less is a collision
+//   MAX_SEPARATION_RATE         how fast its own motion can shrink the separation,
+//                               in units per second, for swept collision tests
+//   hits(pose, cellX, cellZ, x, y, z)
+//                               separation <= 0
+// ObstacleTypes lists the traits; code that handles every type expands over
+// the list (forEachObstacleType) or turns a stored type into a call on the
+// matching trait once (visitObstacleType), so each trait's code is inlined
+// where it is used. A new obstacle type is a new struct appended to the list,
+// plus its enumerator in Game::ObstacleType. Drawing needs nothing else from a
+// trait: every type is drawn as the same cube, placed by its pose and culled
+// by its MOTION_RADIUS.
+//
+// Math supplies sinCos and wrapDegrees: the simulation uses ExactObstacleMath
+// (std::sin / std::cos / std::fmod, the same on every CPU), the renderer's
+// pose kernels a fast polynomial version (ObstacleKernels.h).
+
+struct ObstaclePose {
+    float height;
+    float rotation;  // Degrees about the vertical axis
+    float offsetX, offsetZ;
+};
+
+struct ExactObstacleMath {
+    static void sinCos(float x, float& sinOut, float& cosOut) {
+        sinOut = std::sin(x);
+        cosOut = std::cos(x);
+    }
+    static float wrapDegrees(float degrees) { return std::fmod(degrees, 360.0f); }
+};
+
+// Rises out of the tile to cube height, then stays there
+struct RisingBlock {
+    static constexpr uint8_t TYPE = 1;
+    static constexpr const char* NAME = "rising";
+    static constexpr float RISE_SPEED = 0.5f;  // Height units per second
+    static constexpr float TOP = 1.0f;
+    static constexpr float MOTION_RADIUS = 1.0f;
+    static constexpr float MAX_SEPARATION_RATE = RISE_SPEED;
+
+    template <typename Math>
+    static ObstaclePose pose(float age) {
+        return { std::min(TOP, age * RISE_SPEED), 0.0f, 0.0f, 0.0f };
+    }
+
+    // A unit cube at the pose's height overlapping the player's half-unit slab
+    static float separation(const ObstaclePose& pose, int, int, float, float y, float) {
+        return std::max(y - (pose.height + 0.5f), (pose.height - 0.5f) - (y + 0.5f));
+    }
+
+    static bool hits(const ObstaclePose& pose, int cellX, int cellZ, float x, float y, float z) {
+        return separation(pose, cellX, cellZ, x, y, z) <= 0.0f;
+    }
+};
+
+// Drops from above onto the tile within FALL_TIME seconds
+struct FallingBlock {
+    static constexpr uint8_t TYPE = 2;
+    static constexpr const char* NAME = "falling";
+    static constexpr float START_HEIGHT = 2.0f;
+    static constexpr float FALL_TIME = 1.0f;
+    static constexpr float MOTION_RADIUS = 1.0f;
+    static constexpr float MAX_SEPARATION_RATE = START_HEIGHT / FALL_TIME;
+
+    template <typename Math>
+    static ObstaclePose pose(float age) {
+        float height = age < FALL_TIME ? START_HEIGHT - (age / FALL_TIME) * START_HEIGHT : 0.0f;
+        return { height, 0.0f, 0.0f, 0.0f };
+    }
+
+    static float separation(const ObstaclePose& pose, int cellX, int cellZ, float x, float y, float z) {
+        return RisingBlock::separation(pose, cellX, cellZ, x, y, z);
+    }
+
+    static bool hits(const ObstaclePose& pose, int cellX, int cellZ, float x, float y, float z) {
+        return separation(pose, cellX, cellZ, x, y, z) <= 0.0f;
+    }
+};
+
+// Turns about the vertical axis while bobbing; too tall to land on or roll past
+struct SpinningBlock {
+    static constexpr uint8_t TYPE = 3;
+    static constexpr const char* NAME = "spinning";
+    static constexpr float SPIN_SPEED = 180.0f;  // Degrees per second
+    static constexpr float BOB_CENTER = 0.5f;
+    static constexpr float BOB_AMPLITUDE = 0.3f;
+    static constexpr float BOB_RATE = 3.0f;      // Radians per second
+    static constexpr float HIT_TOP = 1.5f;       // Anything lower than this collides
+    static constexpr float MOTION_RADIUS = 1.0f - (BOB_CENTER - BOB_AMPLITUDE);
+    static constexpr float MAX_SEPARATION_RATE = 0.0f;  // Its collision volume does not move
+
+    template <typename Math>
+    static ObstaclePose pose(float age) {
+        float s, c;
+        Math::sinCos(age * BOB_RATE, s, c);
+        return { BOB_CENTER + BOB_AMPLITUDE * s, Math::wrapDegrees(age * SPIN_SPEED), 0.0f, 0.0f };
+    }
+
+    static float separation(const ObstaclePose&, int, int, float, float y, float) {
+        return y - HIT_TOP;
+    }
+
+    static bool hits(const ObstaclePose& pose, int cellX, int cellZ, float x, float y, float z) {
+        return separation(pose, cellX, cellZ, x, y, z) <= 0.0f;
+    }
+};
+
+// Slides around a circle on the tile's floor
+struct MovingBlock {
+    static constexpr uint8_t TYPE = 4;
+    static constexpr const char* NAME = "moving";
+    static constexpr float ORBIT_RADIUS = 0.5f;
+    static constexpr float ORBIT_RATE = 2.0f;    // Radians per second
+    static constexpr float HIT_TOP = 1.0f;
+    static constexpr float MOTION_RADIUS = 1.1180340f;  // sqrt(ORBIT_RADIUS^2 + 1)
+    static constexpr float MAX_SEPARATION_RATE = ORBIT_RADIUS * ORBIT_RATE;
+
+    template <typename Math>
+    static ObstaclePose pose(float age) {
+        float s, c;
+        Math::sinCos(age * ORBIT_RATE, s, c);
+        return { 0.0f, 0.0f, ORBIT_RADIUS * s, ORBIT_RADIUS * c };
+    }
+
+    // The player's centre inside the block's unit footprint at its current offset
+    static float separation(const ObstaclePose& pose, int cellX, int cellZ, float x, float y, float z) {
+        float gapX = std::max((cellX - 0.5f + pose.offsetX) - x, x - (cellX + 0.5f + pose.offsetX));
+        float gapZ = std::max((cellZ - 0.5f + pose.offsetZ) - z, z - (cellZ + 0.5f + pose.offsetZ));
+        return std::max(y - HIT_TOP, std::max(gapX, gapZ));
+    }
+
+    static bool hits(const ObstaclePose& pose, int cellX, int cellZ, float x, float y, float z) {
+        return separation(pose, cellX, cellZ, x, y, z) <= 0.0f;
+    }
+};
+
+// True if each trait's TYPE is its position in the list, counting from 1
+template <typename... Traits>
+constexpr bool obstacleTypesInOrder() {
+    size_t position = 0;
+    bool inOrder = true;
+    ((inOrder = inOrder && Traits::TYPE == ++position), ...);
+    return inOrder;
+}
+
+template <typename... Traits>
+struct ObstacleTypeList {
+    static constexpr size_t COUNT = sizeof...(Traits);
+    // Per-type tables (pose kernels, buckets, stats) are indexed by TYPE or TYPE - 1
+    static_assert(obstacleTypesInOrder<Traits...>(), "obstacle TYPEs must be 1, 2, ... in list order");
+};
+
+// Every obstacle type, in Game::ObstacleType order starting at 1
+using ObstacleTypes = ObstacleTypeList<RisingBlock, FallingBlock, SpinningBlock, MovingBlock>;
+
+// Calls f(Trait()) for every trait in the list
+template <typename F, typename... Traits>
+inline void forEachObstacleType(ObstacleTypeList<Traits...>, F&& f) {
+    (f(Traits()), ...);
+}
+
+// Returns f(Trait()) for the trait whose TYPE is type, or fallback if there is none
+template <typename R, typename F, typename... Traits>
+inline R visitObstacleType(ObstacleTypeList<Traits...>, int type, R fallback, F&& f) {
+    R result = fallback;
+    (void)((type == Traits::TYPE ? (result = f(Traits()), true) : false) || ...);
+    return result;
+}
+
+// NAME of the given type, or "none"
+inline const char* obstacleTypeName(int type) {
+    return visitObstacleType(ObstacleTypes(), type, "none", [](auto trait) { return decltype(trait)::NAME; });
+}
+
+// MOTION_RADIUS of every type, indexed by type (0 for NONE)
+template <typename... Traits>
+constexpr std::array<float, sizeof...(Traits) + 1> obstacleMotionRadii(ObstacleTypeList<Traits...>) {
+    std::array<float, sizeof...(Traits) + 1> radii{};
+    ((radii[Traits::TYPE] = Traits::MOTION_RADIUS), ...);
+    return radii;
+}
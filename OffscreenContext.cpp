@@ -0,0 +1,150 @@
+#include "OffscreenContext.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_NO_CONFIG_KHR
+#define EGL_NO_CONFIG_KHR ((EGLConfig)0)
+#endif
+
+static GLProc getEglProc(const char* name) {
+    return reinterpret_cast<GLProc>(eglGetProcAddress(name));
+}
+
+static bool hasExtension(const char* list, const char* name) {
+    if (!list) return false;
+    size_t length = std::strlen(name);
+    for (const char* p = std::strstr(list, name); p; p = std::strstr(p + length, name)) {
+        bool startOk = p == list || p[-1] == ' ';
+        bool endOk = p[length] == ' ' || p[length] == '\0';
+        if (startOk && endOk) return true;
+    }
+    return false;
+}
+
+// Prefers the surfaceless platform (no window system at all) and falls back to
+// the default display, which still works when an X server happens to be around
+static EGLDisplay openDisplay() {
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY) return display;
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+OffscreenContext::~OffscreenContext() {
+    destroy();
+}
+
+void OffscreenContext::create(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("offscreen framebuffer size must be positive");
+    }
+    destroy();
+
+    EGLDisplay eglDisplay = openDisplay();
+    EGLint major = 0, minor = 0;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        throw std::runtime_error("cannot open an EGL display");
+    }
+    display = eglDisplay;
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        throw std::runtime_error("EGL display does not support desktop OpenGL");
+    }
+
+    // The framebuffer object is the render target, so no config or surface is needed
+    const char* extensions = eglQueryString(eglDisplay, EGL_EXTENSIONS);
+    if (!hasExtension(extensions, "EGL_KHR_no_config_context") ||
+        !hasExtension(extensions, "EGL_KHR_surfaceless_context")) {
+        throw std::runtime_error("EGL display lacks surfaceless context support");
+    }
+    EGLContext eglContext = eglCreateContext(eglDisplay, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, nullptr);
+    if (eglContext == EGL_NO_CONTEXT) {
+        throw std::runtime_error("cannot create an EGL OpenGL context");
+    }
+    context = eglContext;
+    if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+        throw std::runtime_error("cannot make the EGL context current");
+    }
+
+    glExt.load(getEglProc);
+    if (!glExt.hasFramebuffers) {
+        throw std::runtime_error("offscreen rendering needs framebuffer objects (OpenGL 3.0)");
+    }
+
+    glExt.GenFramebuffers(1, &framebuffer);
+    glExt.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glExt.GenRenderbuffers(2, renderbuffers);
+    glExt.BindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glExt.RenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glExt.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glExt.BindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glExt.RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glExt.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    glExt.BindRenderbuffer(GL_RENDERBUFFER, 0);
+    if (glExt.CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("offscreen framebuffer is incomplete");
+    }
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    fbWidth = width;
+    fbHeight = height;
+}
+
+void OffscreenContext::destroy() {
+    if (context && framebuffer) {
+        glExt.BindFramebuffer(GL_FRAMEBUFFER, 0);
+        glExt.DeleteFramebuffers(1, &framebuffer);
+        glExt.DeleteRenderbuffers(2, renderbuffers);
+    }
+    framebuffer = 0;
+    renderbuffers[0] = renderbuffers[1] = 0;
+    if (display) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context) eglDestroyContext(display, context);
+        eglTerminate(display);
+    }
+    context = nullptr;
+    display = nullptr;
+    fbWidth = fbHeight = 0;
+}
+
+void OffscreenContext::writePPM(const std::string& fileName) {
+    size_t rowBytes = static_cast<size_t>(fbWidth) * 3;
+    pixels.resize(rowBytes * fbHeight);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, fbWidth, fbHeight, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    FILE* file = std::fopen(fileName.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("cannot write " + fileName);
+    }
+    std::fprintf(file, "P6\n%d %d\n255\n", fbWidth, fbHeight);
+    // GL rows run bottom to top, PPM rows top to bottom
+    bool ok = true;
+    for (int y = fbHeight - 1; y >= 0 && ok; --y) {
+        ok = std::fwrite(&pixels[y * rowBytes], 1, rowBytes, file) == rowBytes;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        throw std::runtime_error("error writing " + fileName);
+    }
+}
+
+const char* OffscreenContext::rendererName() const {
+    const GLubyte* name = context ? glGetString(GL_RENDERER) : nullptr;
+    return name ? reinterpret_cast<const char*>(name) : "none";
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "GLExtensions.h"
+
+// OpenGL context without a window, for headless rendering and benchmarks.
+// Uses EGL on Mesa's surfaceless platform (llvmpipe when there is no GPU) and
+// draws into a framebuffer object with RGBA8 color and 24-bit depth, so it
+// needs no X server. Build with -DCROSSY_OFFSCREEN and link -lEGL.
+class OffscreenContext {
+public:
+    OffscreenContext() = default;
+    OffscreenContext(const OffscreenContext&) = delete;
+    OffscreenContext& operator=(const OffscreenContext&) = delete;
+    ~OffscreenContext();
+
+    // Creates the context, makes it current, loads glExt and binds a
+    // width x height framebuffer. Throws std::runtime_error on failure.
+    void create(int width, int height);
+    void destroy();
+
+    // Reads the framebuffer back and writes it as a binary PPM (P6), top row first
+    void writePPM(const std::string& fileName);
+
+    int width() const { return fbWidth; }
+    int height() const { return fbHeight; }
+    const char* rendererName() const;
+
+private:
+    void* display = nullptr;  // EGLDisplay / EGLContext, kept opaque so users need no EGL headers
+    void* context = nullptr;
+    GLuint framebuffer = 0;
+    GLuint renderbuffers[2] = {};
+    int fbWidth = 0, fbHeight = 0;
+    std::vector<unsigned char> pixels;  // Reused by writePPM
+};
@@ -0,0 +1,222 @@
+#include "PathGenerator.h"
+
+#include <algorithm>
+
+#include "ObstacleTraits.h"
+
+// The chunk's tiles, preceded by the last tile before it if there is one. The
+// path only ever steps +x or +z, so the tile on a cell (x, z) can only be the
+// one whose position in the path is x + z - (x + z of the first tile).
+struct TileWindow {
+    PathChunk::Tile tiles[PATH_CHUNK_MAX_TILES + 1];
+    bool hasObstacle[PATH_CHUNK_MAX_TILES + 1] = {};
+    int count = 0;
+
+    int indexOf(int x, int z) const {
+        if (count == 0) return -1;
+        int index = x + z - (tiles[0].x + tiles[0].z);
+        return index >= 0 && index < count && tiles[index].x == x ? index : -1;
+    }
+
+    // Helper function to check if a position is a corner in the path
+    bool isCornerPoint(int x, int z) const {
+        int index = indexOf(x, z);
+        return index >= 0 && tiles[index].isCorner;
+    }
+
+    // Helper function to check if a position is adjacent to a corner in the path
+    bool isAdjacentToCorner(int x, int z) const {
+        return isCornerPoint(x + 1, z) || isCornerPoint(x - 1, z) ||
+            isCornerPoint(x, z + 1) || isCornerPoint(x, z - 1);
+    }
+
+    // Helper function to check if a position already has an obstacle
+    bool hasObstacleAt(int x, int z) const {
+        int index = indexOf(x, z);
+        return index >= 0 && hasObstacle[index];
+    }
+
+    // Helper function to check if a position is adjacent to another obstacle
+    bool isAdjacentToObstacle(int x, int z) const {
+        return hasObstacleAt(x + 1, z) || hasObstacleAt(x - 1, z) ||
+            hasObstacleAt(x, z + 1) || hasObstacleAt(x, z - 1);
+    }
+};
+
+static void addTile(PathCursor& cursor, PathChunk& out, int x, int z, bool isCorner) {
+    cursor.maxX = std::max(cursor.maxX, x);
+    cursor.maxZ = std::max(cursor.maxZ, z);
+    out.tiles[out.tileCount++] = { x, z, isCorner };
+}
+
+// Generates obstacles for the chunk's tiles from startIndex on
+static void generateObstacles(PathCursor& cursor, PathChunk& out, bool hasPrevious, int startIndex) {
+    TileWindow window;
+    if (hasPrevious) {
+        window.tiles[0] = { out.start.lastX, out.start.lastZ, out.start.lastIsCorner };
+        window.hasObstacle[0] = out.start.lastHasObstacle;
+        window.count = 1;
+    }
+    int first = window.count;
+    for (int i = 0; i < out.tileCount; ++i) {
+        window.tiles[window.count++] = out.tiles[i];
+    }
+
+    for (int i = startIndex; i < out.tileCount; ++i) {
+        int x = out.tiles[i].x;
+        int z = out.tiles[i].z;
+
+        // Skip first 5 tiles for safe zone
+        if (i < 5 && startIndex == 0) continue;
+
+        // Skip corners
+        if (window.isCornerPoint(x, z)) continue;
+
+        // Check orthogonal adjacency to any corner
+        if (window.isAdjacentToCorner(x, z)) continue;
+
+        // Check existing obstacles
+        if (window.hasObstacleAt(x, z)) continue;
+        if (window.isAdjacentToObstacle(x, z)) continue;
+
+        // Determine if middle of straight segment
+        int current = first + i;
+        bool isMiddleStraight = false;
+        if (current > 0 && current < window.count - 1) {
+            int prevX = window.tiles[current - 1].x;
+            int prevZ = window.tiles[current - 1].z;
+            int nextX = window.tiles[current + 1].x;
+            int nextZ = window.tiles[current + 1].z;
+
+            // Check straight segment in X-direction
+            if (prevX == x - 1 && prevZ == z && nextX == x + 1 && nextZ == z) {
+                isMiddleStraight = true;
+            }
+            // Check straight segment in Z-direction
+            else if (prevZ == z - 1 && prevX == x && nextZ == z + 1 && nextX == x) {
+                isMiddleStraight = true;
+            }
+        }
+
+        // Adjust probabilities based on position
+        float probability = cursor.obstacleSpawnChance;
+        if (isMiddleStraight) {
+            probability = cursor.straightObstacleChance;  // Higher chance in middle of straight segments
+        }
+
+        if (cursor.rng.nextFloat() < probability) {
+            uint8_t type = static_cast<uint8_t>(1 + cursor.rng.nextBelow(ObstacleTypes::COUNT));
+            out.obstacles[out.obstacleCount++] = { x, z, type };
+            window.hasObstacle[current] = true;
+        }
+    }
+
+    const PathChunk::Tile& last = out.tiles[out.tileCount - 1];
+    cursor.lastX = last.x;
+    cursor.lastZ = last.z;
+    cursor.lastIsCorner = last.isCorner;
+    cursor.lastHasObstacle = window.hasObstacle[window.count - 1];
+}
+
+void generateInitialChunk(const PathCursor& cursor, PathChunk& out) {
+    out.start = cursor;
+    out.tileCount = 0;
+    out.obstacleCount = 0;
+    PathCursor next = cursor;
+    next.maxX = next.maxZ = 0;
+
+    int x = 0, z = 0;
+    // Add starting point (not a corner)
+    addTile(next, out, x, z, false);
+
+    int currentDirection = -1;
+    int straightCounter = 0; // Used to track how long we've been going straight
+
+    for (int i = 1; i < PATH_INITIAL_TILES; ++i) {
+        int nextDirection;
+
+        if (i <= 5) {
+            // For the first few steps, ensure we have a clear starting path without corners
+            nextDirection = 0; // Start with an X direction path
+        }
+        else {
+            // After initial straight segment, introduce possible turns
+            if (straightCounter >= 3) {
+                // Force a turn if we've been going straight for too long
+                nextDirection = (currentDirection == 0) ? 1 : 0;
+                straightCounter = 0;
+            }
+            else {
+                // Otherwise, randomly choose direction with some bias toward continuing
+                if (next.rng.nextBelow(3) == 0) { // 1/3 chance of changing direction
+                    nextDirection = (currentDirection == 0) ? 1 : 0;
+                    straightCounter = 0;
+                }
+                else {
+                    nextDirection = currentDirection == -1 ? next.rng.nextBelow(2) : currentDirection;
+                    straightCounter++;
+                }
+            }
+        }
+
+        // Determine if this will be a corner
+        bool isCorner = (currentDirection != -1 && currentDirection != nextDirection);
+
+        // Move in the chosen direction
+        if (nextDirection == 1)
+            z += 1;
+        else
+            x += 1;
+
+        addTile(next, out, x, z, isCorner);
+        currentDirection = nextDirection;
+    }
+
+    next.direction = currentDirection;
+
+    // Now generate obstacles after the entire path is created
+    generateObstacles(next, out, false, 6); // Skip the first 6 tiles for a clear starting path
+    out.end = next;
+}
+
+void generateNextChunk(const PathCursor& cursor, PathChunk& out) {
+    out.start = cursor;
+    out.tileCount = 0;
+    out.obstacleCount = 0;
+    PathCursor next = cursor;
+
+    // Continue from the last tile to ensure continuity
+    int x = cursor.lastX, z = cursor.lastZ;
+    int currentDirection = cursor.direction;
+
+    for (int i = 0; i < PATH_SEGMENT_TILES; ++i) {
+        int nextDirection;
+        do {
+            // Randomly choose a direction (0 = x, 1 = z)
+            nextDirection = next.rng.nextBelow(2);
+
+            // Force a direction change if we've been going the same way for too long
+            if (i > 0 && i % 5 == 0) {
+                nextDirection = (currentDirection == 0) ? 1 : 0;
+            }
+        } while (nextDirection == currentDirection && i > 0 && next.rng.nextBelow(3) == 0); // Encourage some turns
+
+        // Determine if this will be a corner point
+        bool isCorner = (currentDirection != -1 && currentDirection != nextDirection);
+
+        // Move in the chosen direction
+        if (nextDirection == 1)
+            z += 1;
+        else
+            x += 1;
+
+        addTile(next, out, x, z, isCorner);
+        currentDirection = nextDirection;
+    }
+
+    next.direction = currentDirection;
+
+    // Now generate obstacles for the new path segment
+    generateObstacles(next, out, true, 0);
+    out.end = next;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Rng.h"
+
+// World generation as a pure function of a small state: given where
+// generation stands (PathCursor), the next path segment and its obstacles come
+// out the same no matter which thread computes them or when, so segments can
+// be generated ahead of time (PathStreamer) without changing the world.
+
+static constexpr int PATH_SEGMENT_TILES = 15;
+static constexpr int PATH_INITIAL_TILES = 20;
+static constexpr int PATH_CHUNK_MAX_TILES = PATH_INITIAL_TILES;
+
+// Everything the next segment depends on. Trivially copyable.
+struct PathCursor {
+    Rng rng;
+    int32_t lastX = 0, lastZ = 0;   // Last tile generated
+    int32_t direction = -1;         // Direction of the last step: -1=initial, 0=x, 1=z
+    int32_t maxX = 0, maxZ = 0;
+    bool lastIsCorner = false;
+    bool lastHasObstacle = false;
+    float obstacleSpawnChance = 0.0f;
+    float straightObstacleChance = 0.0f;
+
+    bool operator==(const PathCursor& other) const {
+        return rng == other.rng && lastX == other.lastX && lastZ == other.lastZ && direction == other.direction
+            && maxX == other.maxX && maxZ == other.maxZ && lastIsCorner == other.lastIsCorner
+            && lastHasObstacle == other.lastHasObstacle && obstacleSpawnChance == other.obstacleSpawnChance
+            && straightObstacleChance == other.straightObstacleChance;
+    }
+    bool operator!=(const PathCursor& other) const { return !(*this == other); }
+};
+
+// One generated run of tiles with the obstacles on them
+struct PathChunk {
+    struct Tile {
+        int32_t x, z;
+        bool isCorner;
+    };
+    struct ObstacleSpawn {
+        int32_t x, z;
+        uint8_t type;  // Game::ObstacleType
+    };
+
+    PathCursor start;  // Generation state this chunk continues from
+    PathCursor end;    // ...and the state after it
+    int tileCount = 0;
+    int obstacleCount = 0;
+    Tile tiles[PATH_CHUNK_MAX_TILES];
+    ObstacleSpawn obstacles[PATH_CHUNK_MAX_TILES];
+};
+
+// The first tiles of a game, starting at (0, 0), from a freshly seeded cursor
+void generateInitialChunk(const PathCursor& cursor, PathChunk& out);
+
+// The PATH_SEGMENT_TILES tiles that follow cursor
+void generateNextChunk(const PathCursor& cursor, PathChunk& out);
@@ -0,0 +1,46 @@
+#include "PathStreamer.h"
+
+#include <chrono>
+
+void PathStreamer::restart(const PathCursor& cursor) {
+    stop();
+    queue.clear();
+    expected = cursor;
+    stopping.store(false, std::memory_order_relaxed);
+    worker = std::thread(&PathStreamer::run, this, cursor);
+}
+
+const PathChunk* PathStreamer::take(const PathCursor& cursor) {
+    if (!worker.joinable() || cursor != expected) {
+        ++misses;
+        return nullptr;
+    }
+    // On the right timeline; only a consumer as fast as crossy_sim ever catches up with the worker
+    const PathChunk* chunk;
+    while (!(chunk = queue.front())) {
+        std::this_thread::yield();
+    }
+    ++hits;
+    expected = chunk->end;
+    return chunk;
+}
+
+void PathStreamer::stop() {
+    stopping.store(true, std::memory_order_relaxed);
+    if (worker.joinable()) worker.join();
+}
+
+void PathStreamer::run(PathCursor cursor) {
+    while (!stopping.load(std::memory_order_relaxed)) {
+        PathChunk* slot = queue.beginPush();
+        if (!slot) {
+            // Polled rather than woken, so release() stays a single atomic store; the
+            // player takes about a second per segment, so AHEAD segments last far longer
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        generateNextChunk(cursor, *slot);
+        cursor = slot->end;
+        queue.push();
+    }
+}
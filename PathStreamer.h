@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "PathGenerator.h"
+#include "SpscQueue.h"
+
+// Generates path segments on a worker thread, a few ahead of the game that
+// consumes them, so extending the path costs the simulation no generation
+// work. Segments are handed over in place through a lock-free SPSC queue.
+// Generation is deterministic, so a streamed world is identical to one
+// generated inline. Serves one game at a time.
+class PathStreamer {
+public:
+    static constexpr size_t AHEAD = 4;  // Segments generated in advance
+
+    PathStreamer() = default;
+    ~PathStreamer() { stop(); }
+
+    PathStreamer(const PathStreamer&) = delete;
+    PathStreamer& operator=(const PathStreamer&) = delete;
+
+    // Discards anything queued and generates ahead from cursor
+    void restart(const PathCursor& cursor);
+
+    // The chunk that continues from cursor, or nullptr if the streamer is
+    // working on another timeline (after a reset or a snapshot restore); the
+    // caller then generates the chunk inline and restarts the streamer. The
+    // chunk stays valid until release().
+    const PathChunk* take(const PathCursor& cursor);
+
+    void release() { queue.pop(); }
+
+    uint64_t streamed() const { return hits; }
+    uint64_t missed() const { return misses; }
+
+private:
+    SpscQueue<PathChunk, AHEAD> queue;
+    std::thread worker;
+    std::atomic<bool> stopping{ false };
+    PathCursor expected;  // Where the next queued chunk starts (consumer side)
+    uint64_t hits = 0, misses = 0;
+
+    void stop();
+    void run(PathCursor cursor);
+};
@@ -0,0 +1,178 @@
+#include "Planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_set>
+
+#include "GameSnapshot.h"
+#include "Replay.h"
+#include "ThreadPool.h"
+
+// Actions tried at every decision point, most promising first so that good
+// plans are found early and the score bound prunes sooner: jumps and rolls in
+// the directions the path grows in, the wait, then moves backwards
+static const uint8_t ACTIONS[] = {
+    INPUT_D | INPUT_SPACE, INPUT_S | INPUT_SPACE, INPUT_D, INPUT_S, 0,
+    INPUT_A, INPUT_W, INPUT_A | INPUT_SPACE, INPUT_W | INPUT_SPACE,
+};
+static constexpr int ACTION_COUNT = sizeof(ACTIONS) / sizeof(ACTIONS[0]);
+
+// A decision point on the search stack
+struct PlanFrame {
+    GameSnapshot state;
+    long tick = 0;       // Ticks simulated to reach state
+    int nextAction = 0;  // Index into ACTIONS of the next child to try
+    uint8_t mask = 0;    // Action taken from here towards the frame above
+};
+
+// Updates a move at the given speed takes to complete, after the tick that starts it
+static long moveTicks(float speed, float dt) {
+    float progress = 0.0f;
+    long ticks = 0;
+    while (progress < 1.0f) {
+        progress += speed * dt;
+        ++ticks;
+    }
+    return ticks;
+}
+
+// Identifies a decision point by everything later moves depend on: the
+// player's tile, the tick, the score so far, which tiles are in the window and
+// how far the decayed ones have decayed, and the obstacles on them
+static uint64_t stateKey(const Game& game, long tick) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](int64_t value) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash ^= static_cast<uint64_t>(value >> (byte * 8)) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    int px = static_cast<int>(std::round(game.playerX));
+    int pz = static_cast<int>(std::round(game.playerZ));
+    mix(px);
+    mix(pz);
+    mix(tick);
+    mix(game.score);
+    mix(static_cast<int64_t>(game.path.frontSeq()));
+    mix(static_cast<int64_t>(game.path.endSeq()));
+    // Tiles the player has never been ahead of still have their full lifetime
+    for (size_t i = 0; i < game.path.size(); ++i) {
+        float lifetime = game.path.lifetime(i);
+        if (lifetime == game.path.maxLifetime(i)) continue;
+        int32_t lifetimeBits;
+        std::memcpy(&lifetimeBits, &lifetime, sizeof(lifetimeBits));
+        mix(static_cast<int64_t>(i));
+        mix(lifetimeBits);
+    }
+    for (const auto& obstacle : game.obstacles) {
+        if (!obstacle.active) continue;
+        int64_t spawnBits;
+        static_assert(sizeof(spawnBits) == sizeof(obstacle.spawnTime), "spawn time is a double");
+        std::memcpy(&spawnBits, &obstacle.spawnTime, sizeof(spawnBits));
+        mix(obstacle.x);
+        mix(obstacle.z);
+        mix(spawnBits);
+    }
+    return hash;
+}
+
+PlanResult planSeed(uint64_t seed, const PlanConfig& config) {
+    PlanResult result;
+    result.seed = seed;
+
+    Game game;
+    game.tuning = config.tuning;
+    game.reset(seed);
+
+    // Fastest possible progress, for the bound: a jump covers two tiles, a roll one
+    double tilesPerTick = std::max(2.0 / moveTicks(Game::JUMP_SPEED, config.dt),
+        1.0 / moveTicks(Game::ROLL_SPEED, config.dt));
+    auto scoreBound = [&](const Game& g, long tick) {
+        int reachable = static_cast<int>(g.playerX + g.playerZ)
+            + static_cast<int>(std::ceil(tilesPerTick * (config.maxTicks - tick)));
+        return std::max(g.score, reachable);
+    };
+
+    std::unordered_set<uint64_t> seen;
+    std::vector<PlanFrame> frames(1);
+    frames[0].state.capture(game);
+    seen.insert(stateKey(game, 0));
+    result.bestScore = game.score;
+    size_t depth = 0;
+
+    while (result.nodes < config.maxNodes) {
+        PlanFrame& frame = frames[depth];
+        if (frame.nextAction == ACTION_COUNT) {
+            if (depth == 0) {
+                result.exhaustive = true;
+                break;
+            }
+            --depth;
+            continue;
+        }
+        frame.mask = ACTIONS[frame.nextAction++];
+        frame.state.restore(game);
+        long tick = frame.tick;
+        ++result.nodes;
+
+        // Records a new best on the tick the score goes up, so the plan can stop there
+        auto step = [&] {
+            game.updateGame(config.dt);
+            ++tick;
+            if (game.score > result.bestScore) {
+                result.bestScore = game.score;
+                result.bestTick = tick;
+                result.bestInputs.assign(tick, 0);
+                for (size_t d = 0; d <= depth; ++d) {
+                    result.bestInputs[frames[d].tick] = frames[d].mask;
+                }
+            }
+        };
+
+        // The keys only need to be down on the tick the move starts
+        applyInputMask(game, frame.mask);
+        step();
+        applyInputMask(game, 0);
+        if (frame.mask == 0) {
+            for (int i = 1; i < config.waitTicks && tick < config.maxTicks; ++i) {
+                step();
+            }
+        }
+        else {
+            while ((game.isRolling || game.isJumping) && !game.gameOver && tick < config.maxTicks) {
+                step();
+            }
+        }
+
+        if (game.gameOver || tick >= config.maxTicks) continue;
+        if (scoreBound(game, tick) <= result.bestScore) continue;
+        if (!seen.insert(stateKey(game, tick)).second) continue;
+
+        ++depth;
+        if (depth == frames.size()) frames.emplace_back();
+        frames[depth].state.capture(game);
+        frames[depth].tick = tick;
+        frames[depth].nextAction = 0;
+    }
+
+    if (result.bestScore >= config.targetScore) result.solvable = Solvability::SOLVABLE;
+    else result.solvable = result.exhaustive ? Solvability::UNSOLVABLE : Solvability::UNKNOWN;
+    return result;
+}
+
+std::vector<PlanResult> planSeeds(const std::vector<uint64_t>& seeds, const PlanConfig& config) {
+    // Each task writes only its own slot, so workers never share results
+    std::vector<PlanResult> results(seeds.size());
+    ThreadPool pool(config.threads);
+    for (size_t i = 0; i < seeds.size(); ++i) {
+        PlanResult* slot = &results[i];
+        uint64_t seed = seeds[i];
+        pool.submit([slot, seed, &config] {
+            *slot = planSeed(seed, config);
+        });
+    }
+    pool.wait();
+    return results;
+}
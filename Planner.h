@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Game.h"
+
+// Search-based playtester. For one seed it searches the time-expanded state
+// space (tile x tick x action) by depth-first search over GameSnapshots: at
+// every tick where the player stands still it tries each roll, each jump and
+// a short wait, simulates the move with the real rules, and prunes states it
+// has already seen and branches that cannot beat the best score found so far.
+// Scores are counted as the game counts them, so progress made during a jump
+// that ends the game still counts. A level is solvable if some plan reaches
+// the target score within the horizon, and unsolvable if the search finishes
+// within its node budget without one; otherwise it is unknown. Moves start
+// only when the previous move or wait is over, so a finished search has tried
+// every plan whose waits are multiples of waitTicks, and its best score is
+// exact among those (waitTicks = 1 searches every tick). Levels that block the
+// player early rarely finish: proving that nothing gets past the block means
+// trying every way of reaching it.
+//
+// States are merged only when everything later moves depend on is the same:
+// the player's tile, the tick, the score, the lifetimes of the tiles that have
+// started to decay (backward moves leave decayed tiles ahead of the player) and
+// the spawn times of the obstacles, which fix their motion from then on.
+struct PlanConfig {
+    float dt = 1.0f / 60.0f;
+    long maxTicks = 60 * 60;      // Horizon
+    int targetScore = 100;        // Score a plan must reach within the horizon for the level to count as solvable
+    int waitTicks = 6;            // Length of the wait action; moves start only on this grid after a wait
+    long maxNodes = 1000000;      // Expansion budget per seed
+    unsigned threads = 0;         // 0 = one per hardware thread
+    Game::Tuning tuning;
+};
+
+enum class Solvability {
+    UNKNOWN,     // No plan found reaches the target, but the search ran out of budget
+    SOLVABLE,    // Some plan reaches config.targetScore
+    UNSOLVABLE   // The search finished and no plan reaches it
+};
+
+struct PlanResult {
+    uint64_t seed = 0;
+    Solvability solvable = Solvability::UNKNOWN;
+    bool exhaustive = false;      // Search finished within the budget, so bestScore is the best possible on the waitTicks grid
+    int bestScore = 0;
+    long bestTick = 0;            // Tick at which the best plan first reaches bestScore
+    long nodes = 0;               // States expanded
+    std::vector<uint8_t> bestInputs; // Per-tick input masks (InputBit) of the best plan, up to bestTick
+};
+
+PlanResult planSeed(uint64_t seed, const PlanConfig& config);
+
+// Plans every seed on a ThreadPool; results are in the order of seeds
+std::vector<PlanResult> planSeeds(const std::vector<uint64_t>& seeds, const PlanConfig& config);
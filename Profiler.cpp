@@ -0,0 +1,116 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+Profiler profiler;
+
+static const char* PHASE_NAMES[] = {
+    "frame", "update", "collect", "sky", "grid", "tiles", "obstacles", "player", "labels", "hud"
+};
+static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == static_cast<size_t>(ProfilePhase::COUNT),
+    "every phase needs a name");
+
+// Trace-event thread id of the GPU track
+static const int GPU_TRACK = 1000;
+
+const char* profilePhaseName(ProfilePhase phase) {
+    size_t index = static_cast<size_t>(phase);
+    return index < static_cast<size_t>(ProfilePhase::COUNT) ? PHASE_NAMES[index] : "?";
+}
+
+static uint16_t currentThreadNumber() {
+    static std::atomic<uint16_t> nextNumber{ 0 };
+    thread_local uint16_t number = nextNumber.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+Profiler::Profiler() : slots(new Slot[CAPACITY]) {
+    scratchEvents.reserve(CAPACITY);
+}
+
+void Profiler::record(ProfilePhase phase, bool gpu, uint64_t startNs, uint64_t durationNs) {
+    uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index & (CAPACITY - 1)];
+    uint64_t duration = std::min<uint64_t>(durationNs, UINT32_MAX);
+    uint64_t packed = duration | (static_cast<uint64_t>(phase) << 32) | (static_cast<uint64_t>(gpu) << 40)
+        | (static_cast<uint64_t>(currentThreadNumber()) << 48);
+
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.start.store(startNs, std::memory_order_relaxed);
+    slot.packed.store(packed, std::memory_order_relaxed);
+    slot.seq.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::snapshot(std::vector<ProfileEvent>& out, size_t maxEvents) const {
+    out.clear();
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t count = std::min<uint64_t>({ end, maxEvents, CAPACITY });
+    for (uint64_t index = end - count; index < end; ++index) {
+        const Slot& slot = slots[index & (CAPACITY - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != index + 1) continue;  // Not written yet, or reused
+        uint64_t start = slot.start.load(std::memory_order_relaxed);
+        uint64_t packed = slot.packed.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != index + 1) continue;
+
+        out.push_back({ start, static_cast<uint32_t>(packed), static_cast<ProfilePhase>((packed >> 32) & 0xFF),
+            ((packed >> 40) & 1) != 0, static_cast<uint16_t>(packed >> 48) });
+    }
+}
+
+void Profiler::summarize(size_t maxEvents, PhaseSummary cpu[], PhaseSummary gpu[]) {
+    snapshot(scratchEvents, maxEvents);
+    for (auto& side : scratchDurations) {
+        for (auto& durations : side) durations.clear();
+    }
+    for (const ProfileEvent& event : scratchEvents) {
+        scratchDurations[event.gpu][static_cast<int>(event.phase)].push_back(event.durationNs * 1e-6f);
+    }
+
+    for (int gpuSide = 0; gpuSide < 2; ++gpuSide) {
+        PhaseSummary* summaries = gpuSide ? gpu : cpu;
+        for (int phase = 0; phase < static_cast<int>(ProfilePhase::COUNT); ++phase) {
+            std::vector<float>& durations = scratchDurations[gpuSide][phase];
+            PhaseSummary summary;
+            summary.samples = static_cast<int>(durations.size());
+            if (!durations.empty()) {
+                double sum = 0.0;
+                for (float d : durations) sum += d;
+                summary.avgMs = sum / durations.size();
+                summary.minMs = *std::min_element(durations.begin(), durations.end());
+                auto p99 = durations.begin() + (durations.size() * 99) / 100;
+                std::nth_element(durations.begin(), p99, durations.end());
+                summary.p99Ms = *p99;
+            }
+            summaries[phase] = summary;
+        }
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string& fileName) const {
+    std::vector<ProfileEvent> events;
+    snapshot(events, CAPACITY);
+
+    FILE* file = std::fopen(fileName.c_str(), "w");
+    if (!file) return false;
+
+    // Timestamps in microseconds from the first event. GPU spans sit on their own
+    // track at the time they were submitted, since elapsed-time queries carry no start.
+    uint64_t origin = UINT64_MAX;
+    for (const ProfileEvent& event : events) origin = std::min(origin, event.startNs);
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"GPU\"}}",
+        GPU_TRACK);
+    for (const ProfileEvent& event : events) {
+        std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+            "\"ts\":%.3f,\"dur\":%.3f}",
+            profilePhaseName(event.phase), event.gpu ? "gpu" : "cpu", event.gpu ? GPU_TRACK : event.thread,
+            (event.startNs - origin) * 1e-3, event.durationNs * 1e-3);
+    }
+    std::fprintf(file, "\n]}\n");
+    bool ok = !std::ferror(file);
+    return std::fclose(file) == 0 && ok;
+}
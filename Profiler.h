@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Parts of a frame the profiler tells apart
+enum class ProfilePhase : uint8_t {
+    FRAME,      // All of Renderer::drawFrame
+    UPDATE,     // Game::updateGame
+    COLLECT,    // Culling and draw-list building
+    SKY,        // Sky dome and clouds
+    GRID,
+    TILES,
+    OBSTACLES,
+    PLAYER,     // Player cube and direction arrows
+    LABELS,
+    HUD,
+    COUNT
+};
+
+const char* profilePhaseName(ProfilePhase phase);
+
+struct ProfileEvent {
+    uint64_t startNs;      // Profiler::nowNs() at the start; GPU spans use the time they were submitted
+    uint32_t durationNs;
+    ProfilePhase phase;
+    bool gpu;
+    uint16_t thread;       // Small per-thread number, in order of each thread's first event
+};
+
+struct PhaseSummary {
+    int samples = 0;
+    double minMs = 0.0, avgMs = 0.0, p99Ms = 0.0;
+};
+
+// Timing events of the most recent frames, in a fixed ring that any thread can
+// append to without locking: writers claim a slot with one atomic increment and
+// publish it with a per-slot sequence number, and readers skip slots that are
+// being rewritten. Old events are overwritten once the ring is full.
+//
+// The timers themselves (PROFILE_SCOPE and the renderer's GPU spans) are only
+// compiled in with -DCROSSY_PROFILE; without it nothing is ever recorded.
+class Profiler {
+public:
+#ifdef CROSSY_PROFILE
+    static constexpr bool COMPILED_IN = true;
+#else
+    static constexpr bool COMPILED_IN = false;
+#endif
+    static constexpr size_t CAPACITY = 1 << 15;
+
+    Profiler();
+
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void record(ProfilePhase phase, bool gpu, uint64_t startNs, uint64_t durationNs);
+
+    // Copies up to maxEvents of the newest events, oldest first
+    void snapshot(std::vector<ProfileEvent>& out, size_t maxEvents) const;
+
+    // Min, average and 99th percentile of each phase over the newest maxEvents
+    // events, for CPU and GPU separately. Call from one thread at a time.
+    void summarize(size_t maxEvents, PhaseSummary cpu[], PhaseSummary gpu[]);
+
+    // Writes every event still in the ring as Chrome trace-event JSON
+    // (chrome://tracing, Perfetto). Returns false if the file cannot be written.
+    bool writeChromeTrace(const std::string& fileName) const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{ 0 };     // Index + 1 once written, 0 while being written
+        std::atomic<uint64_t> start{ 0 };
+        std::atomic<uint64_t> packed{ 0 };  // duration | phase << 32 | gpu << 40 | thread << 48
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head{ 0 };
+    std::vector<ProfileEvent> scratchEvents;  // Reused by summarize
+    std::vector<float> scratchDurations[2][static_cast<int>(ProfilePhase::COUNT)];
+};
+
+extern Profiler profiler;
+
+// Records the time from construction to destruction as one CPU event
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase) : phase(phase), start(Profiler::nowNs()) {}
+    ~ProfileScope() { profiler.record(phase, false, start, Profiler::nowNs() - start); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfilePhase phase;
+    uint64_t start;
+};
+
+#ifdef CROSSY_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(phase) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(phase)
+#else
+#define PROFILE_SCOPE(phase) ((void)0)
+#endif
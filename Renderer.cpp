@@ -0,0 +1,1091 @@
+#include "Renderer.h"
+
+#include <GL/glu.h>
+#include <GL/glut.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+// Tessellations shared by both backends, so they draw the same shapes
+static const float SKY_RADIUS = 50.0f;
+static const int SKY_SLICES = 32, SKY_STACKS = 32;
+static const float CLOUD_RADIUS = 3.0f;
+// Cloud tessellations by view depth: further away a cloud covers too few pixels
+// for the finer meshes to show, so it gets a coarser one
+static const struct {
+    float maxDepth;
+    int slices, stacks;
+} CLOUD_LODS[] = { { 15.0f, 16, 16 }, { 25.0f, 10, 10 }, { 1e30f, 6, 6 } };
+static const float ARROW_CONE_BASE = 0.15f, ARROW_CONE_HEIGHT = 0.3f;
+static const int ARROW_CONE_SLICES = 16, ARROW_CONE_STACKS = 8;
+static const int GRID_HALF_EXTENT = 50;
+static const float GRID_Y = -0.5f;
+static const float NEAR_PLANE = 0.1f, FAR_PLANE = 100.0f;
+static const float FOG_START = 20.0f, FOG_END = 40.0f;
+static const float TILE_EDGE_SCALE = 1.01f;
+static const float OBSTACLE_SIZE = 0.8f, OBSTACLE_EDGE_SIZE = 0.81f;
+// Half the diagonal of a unit cube: cubes are culled by their bounding spheres
+static const float CUBE_RADIUS_PER_SIZE = 0.8660254f;
+// Distance from (x, 1, z) to the furthest centre of each obstacle type, indexed by type
+static constexpr auto OBSTACLE_MOTION_RADII = obstacleMotionRadii(ObstacleTypes());
+
+// Fixed-function state for each material of the draw list; the instanced material
+// uses the shader below instead
+struct MaterialState {
+    bool program, lighting, colorMaterial;
+    GLfloat ambient[4], diffuse[4], specular[4];
+    GLfloat shininess;
+};
+
+static const MaterialState MATERIALS[] = {
+    // MAT_UNLIT: flat colored sky, clouds and outlines
+    { false, false, true, {}, {}, {}, 0.0f },
+    // MAT_COLORED: lit, colored by the current color (tiles, grid)
+    { false, true, true, {}, {}, { 0.5f, 0.5f, 0.5f, 1.0f }, 50.0f },
+    // MAT_OBSTACLE
+    { false, true, false, { 0.3f, 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f }, { 0.5f, 0.5f, 0.5f, 1.0f }, 50.0f },
+    // MAT_PLAYER
+    { false, true, false, { 0.0f, 0.2f, 0.0f, 1.0f }, { 0.0f, 0.8f, 0.0f, 1.0f }, { 0.5f, 1.0f, 0.5f, 1.0f }, 50.0f },
+    // MAT_ARROW
+    { false, true, false, { 0.5f, 0.4f, 0.1f, 1.0f }, { 1.0f, 0.8f, 0.0f, 1.0f }, { 1.0f, 1.0f, 0.5f, 1.0f }, 50.0f },
+    // MAT_INSTANCED
+    { true, true, true, {}, {}, {}, 0.0f },
+};
+
+// Attribute slots of the instanced cube shader
+enum InstanceAttribute { ATTRIB_POSITION, ATTRIB_NORMAL, ATTRIB_TRANSFORM, ATTRIB_ALPHA };
+
+// Per-vertex lighting and linear fog matching the fixed-function state set up in
+// init(): LIGHT0 as a point light, the global ambient term and a non-local viewer.
+// Outlines (lit = false) take a flat color, as the immediate path draws them.
+static const char* INSTANCE_VERTEX_SHADER = R"(
+#version 120
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec4 instanceTransform;
+attribute vec2 instanceAlpha;
+uniform float scale;
+uniform bool lit;
+uniform vec3 edgeColor;
+uniform vec4 ambient, diffuse, specular;
+uniform float shininess;
+varying vec4 color;
+varying float fogDepth;
+
+vec3 rotateY(vec3 v, float c, float s) {
+    return vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+}
+
+void main() {
+    float c = cos(instanceTransform.w), s = sin(instanceTransform.w);
+    vec4 eye = gl_ModelViewMatrix * vec4(rotateY(position * scale, c, s) + instanceTransform.xyz, 1.0);
+    gl_Position = gl_ProjectionMatrix * eye;
+    fogDepth = abs(eye.z);
+
+    if (!lit) {
+        color = vec4(edgeColor, instanceAlpha.y);
+        return;
+    }
+    vec3 n = normalize(gl_NormalMatrix * rotateY(normal, c, s));
+    vec3 l = normalize(gl_LightSource[0].position.xyz - eye.xyz);
+    float nl = max(dot(n, l), 0.0);
+    vec3 rgb = (gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb) * ambient.rgb
+        + gl_LightSource[0].diffuse.rgb * diffuse.rgb * nl;
+    if (nl > 0.0) {
+        float nh = max(dot(n, normalize(l + vec3(0.0, 0.0, 1.0))), 0.0);
+        rgb += gl_LightSource[0].specular.rgb * specular.rgb * pow(nh, shininess);
+    }
+    color = vec4(clamp(rgb, 0.0, 1.0), diffuse.a * instanceAlpha.x);
+}
+)";
+
+static const char* INSTANCE_FRAGMENT_SHADER = R"(
+#version 120
+varying vec4 color;
+varying float fogDepth;
+
+void main() {
+    float f = clamp((gl_Fog.end - fogDepth) * gl_Fog.scale, 0.0, 1.0);
+    gl_FragColor = vec4(mix(gl_Fog.color.rgb, color.rgb, f), color.a);
+}
+)";
+
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glExt.CreateShader(type);
+    glExt.ShaderSource(shader, 1, &source, nullptr);
+    glExt.CompileShader(shader);
+    GLint ok = GL_FALSE;
+    glExt.GetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glExt.GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Shader compilation failed: " << log << std::endl;
+        glExt.DeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+PlayerPose capturePose(const Game& g) {
+    return { g.playerX, g.playerY, g.playerZ, g.jumpHeight, g.jumpProgress, g.rollAngle,
+        g.rollDirection, g.isRolling, g.isJumping };
+}
+
+void Renderer::init(RenderBackend requested, bool glutAvailable) {
+    const GLubyte* version = glGetString(GL_VERSION);
+    if (!version) {
+        throw std::runtime_error("OpenGL not properly initialized!");
+    }
+    std::cout << "OpenGL Version: " << version << std::endl;
+
+    useGlut = glutAvailable;
+    activeBackend = requested;
+    if (activeBackend == RenderBackend::RETAINED && !glExt.hasBuffers) {
+        std::cerr << "Vertex buffer objects not supported; using immediate mode" << std::endl;
+        activeBackend = RenderBackend::IMMEDIATE;
+    }
+    if (activeBackend == RenderBackend::IMMEDIATE && !useGlut) {
+        throw std::runtime_error("immediate mode rendering needs GLUT");
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
+    glShadeModel(GL_SMOOTH);
+
+    glEnable(GL_LIGHTING);
+    glEnable(GL_LIGHT0);
+    glEnable(GL_COLOR_MATERIAL);
+    // Shapes are unit meshes scaled by their model matrix
+    glEnable(GL_NORMALIZE);
+
+    GLfloat lightPos[] = { 10.0f, 15.0f, 10.0f, 1.0f };
+    GLfloat ambientLight[] = { 0.4f, 0.4f, 0.4f, 1.0f };
+    GLfloat diffuseLight[] = { 0.8f, 0.8f, 0.8f, 1.0f };
+    GLfloat specularLight[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
+    glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
+    glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
+    glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
+
+    GLfloat fogColor[] = { 0.2f, 0.3f, 0.4f, 1.0f };
+    glFogi(GL_FOG_MODE, GL_LINEAR);
+    glFogfv(GL_FOG_COLOR, fogColor);
+    glFogf(GL_FOG_DENSITY, 0.35f);
+    glHint(GL_FOG_HINT, GL_DONT_CARE);
+    glFogf(GL_FOG_START, FOG_START);
+    glFogf(GL_FOG_END, FOG_END);
+    glEnable(GL_FOG);
+
+    if (activeBackend == RenderBackend::RETAINED) {
+        cubeMesh = upload(makeSolidCube(1.0f));
+        wireCubeMesh = upload(makeWireCube(1.0f));
+        skyMesh = upload(makeSphere(SKY_RADIUS, SKY_SLICES, SKY_STACKS));
+        for (int lod = 0; lod < CLOUD_LOD_COUNT; ++lod) {
+            cloudMeshes[lod] = upload(makeSphere(CLOUD_RADIUS, CLOUD_LODS[lod].slices, CLOUD_LODS[lod].stacks));
+        }
+        coneMesh = upload(makeCone(ARROW_CONE_BASE, ARROW_CONE_HEIGHT, ARROW_CONE_SLICES, ARROW_CONE_STACKS));
+        gridMesh = upload(makeGrid(GRID_HALF_EXTENT, GRID_Y));
+
+        if (glExt.hasInstancing && buildInstanceProgram()) {
+            glExt.GenBuffers(1, &instanceBuffer);
+        }
+        if (useGlut) {
+            initHud();
+        }
+    }
+    if (Profiler::COMPILED_IN && !gpuTimer.init()) {
+        std::cerr << "Timer queries not supported; profiling CPU time only" << std::endl;
+    }
+    std::cout << "Renderer: " << (activeBackend == RenderBackend::RETAINED ? "retained" : "immediate")
+        << (instancing() ? ", instanced" : "") << ", " << obstacleKernels->name << " obstacle kernels" << std::endl;
+}
+
+void Renderer::resize(int width, int height) {
+    if (height == 0) height = 1;
+    float ratio = 1.0f * width / height;
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glViewport(0, 0, width, height);
+    gluPerspective(45.0f, ratio, NEAR_PLANE, FAR_PLANE);
+    glMatrixMode(GL_MODELVIEW);
+}
+
+Renderer::GpuMesh Renderer::upload(const MeshData& mesh) {
+    GpuMesh gpu;
+    gpu.primitive = mesh.primitive == MeshData::LINES ? GL_LINES : GL_TRIANGLES;
+    gpu.stride = static_cast<GLsizei>(mesh.floatsPerVertex() * sizeof(float));
+    gpu.hasNormals = mesh.hasNormals;
+    gpu.hasColors = mesh.hasColors;
+
+    glExt.GenBuffers(1, &gpu.vertexBuffer);
+    glExt.BindBuffer(GL_ARRAY_BUFFER, gpu.vertexBuffer);
+    glExt.BufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_STATIC_DRAW);
+    glExt.BindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (mesh.indices.empty()) {
+        gpu.count = mesh.vertexCount();
+    }
+    else {
+        gpu.count = static_cast<GLsizei>(mesh.indices.size());
+        glExt.GenBuffers(1, &gpu.indexBuffer);
+        glExt.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.indexBuffer);
+        glExt.BufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(uint32_t), mesh.indices.data(),
+            GL_STATIC_DRAW);
+        glExt.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    return gpu;
+}
+
+void Renderer::drawMesh(const GpuMesh& mesh) {
+    glExt.BindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, mesh.stride, nullptr);
+
+    size_t offset = 3 * sizeof(float);
+    if (mesh.hasNormals) {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, mesh.stride, reinterpret_cast<const void*>(offset));
+        offset += 3 * sizeof(float);
+    }
+    if (mesh.hasColors) {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(3, GL_FLOAT, mesh.stride, reinterpret_cast<const void*>(offset));
+    }
+
+    if (mesh.indexBuffer) {
+        glExt.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+        glDrawElements(mesh.primitive, mesh.count, GL_UNSIGNED_INT, nullptr);
+        glExt.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    else {
+        glDrawArrays(mesh.primitive, 0, mesh.count);
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glExt.BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool Renderer::buildInstanceProgram() {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, INSTANCE_VERTEX_SHADER);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, INSTANCE_FRAGMENT_SHADER);
+    if (!vertexShader || !fragmentShader) {
+        if (vertexShader) glExt.DeleteShader(vertexShader);
+        if (fragmentShader) glExt.DeleteShader(fragmentShader);
+        std::cerr << "Instanced drawing disabled" << std::endl;
+        return false;
+    }
+
+    GLuint program = glExt.CreateProgram();
+    glExt.AttachShader(program, vertexShader);
+    glExt.AttachShader(program, fragmentShader);
+    glExt.BindAttribLocation(program, ATTRIB_POSITION, "position");
+    glExt.BindAttribLocation(program, ATTRIB_NORMAL, "normal");
+    glExt.BindAttribLocation(program, ATTRIB_TRANSFORM, "instanceTransform");
+    glExt.BindAttribLocation(program, ATTRIB_ALPHA, "instanceAlpha");
+    glExt.LinkProgram(program);
+    glExt.DeleteShader(vertexShader);
+    glExt.DeleteShader(fragmentShader);
+
+    GLint ok = GL_FALSE;
+    glExt.GetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glExt.GetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "Shader link failed: " << log << "\nInstanced drawing disabled" << std::endl;
+        glExt.DeleteProgram(program);
+        return false;
+    }
+
+    instanceProgram.program = program;
+    instanceProgram.scale = glExt.GetUniformLocation(program, "scale");
+    instanceProgram.lit = glExt.GetUniformLocation(program, "lit");
+    instanceProgram.edgeColor = glExt.GetUniformLocation(program, "edgeColor");
+    instanceProgram.ambient = glExt.GetUniformLocation(program, "ambient");
+    instanceProgram.diffuse = glExt.GetUniformLocation(program, "diffuse");
+    instanceProgram.specular = glExt.GetUniformLocation(program, "specular");
+    instanceProgram.shininess = glExt.GetUniformLocation(program, "shininess");
+    return true;
+}
+
+void Renderer::uploadInstances() {
+    // Orphan last frame's storage instead of waiting for the GPU to finish with it
+    glExt.BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glExt.BufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    glExt.BufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(Instance), instances.data());
+    glExt.BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Draws the mesh once per instance in the given range of the uploaded instance buffer,
+// with the instance program bound
+void Renderer::drawInstanced(const GpuMesh& mesh, uint32_t first, uint32_t count) {
+    glExt.BindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+    glExt.EnableVertexAttribArray(ATTRIB_POSITION);
+    glExt.VertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, mesh.stride, nullptr);
+    if (mesh.hasNormals) {
+        glExt.EnableVertexAttribArray(ATTRIB_NORMAL);
+        glExt.VertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, mesh.stride,
+            reinterpret_cast<const void*>(3 * sizeof(float)));
+    }
+
+    glExt.BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glExt.EnableVertexAttribArray(ATTRIB_TRANSFORM);
+    size_t base = first * sizeof(Instance);
+    glExt.VertexAttribPointer(ATTRIB_TRANSFORM, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+        reinterpret_cast<const void*>(base + offsetof(Instance, x)));
+    glExt.VertexAttribDivisor(ATTRIB_TRANSFORM, 1);
+    glExt.EnableVertexAttribArray(ATTRIB_ALPHA);
+    glExt.VertexAttribPointer(ATTRIB_ALPHA, 2, GL_FLOAT, GL_FALSE, sizeof(Instance),
+        reinterpret_cast<const void*>(base + offsetof(Instance, alpha)));
+    glExt.VertexAttribDivisor(ATTRIB_ALPHA, 1);
+
+    glExt.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+    glExt.DrawElementsInstanced(mesh.primitive, mesh.count, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+    glExt.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    glExt.VertexAttribDivisor(ATTRIB_TRANSFORM, 0);
+    glExt.VertexAttribDivisor(ATTRIB_ALPHA, 0);
+    glExt.DisableVertexAttribArray(ATTRIB_ALPHA);
+    glExt.DisableVertexAttribArray(ATTRIB_TRANSFORM);
+    glExt.DisableVertexAttribArray(ATTRIB_NORMAL);
+    glExt.DisableVertexAttribArray(ATTRIB_POSITION);
+    glExt.BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::setInstanceMaterial(float size, const GLfloat* ambient, const GLfloat* diffuse) {
+    glExt.Uniform1f(instanceProgram.scale, size);
+    glExt.Uniform1i(instanceProgram.lit, GL_TRUE);
+    glExt.Uniform4f(instanceProgram.ambient, ambient[0], ambient[1], ambient[2], ambient[3]);
+    glExt.Uniform4f(instanceProgram.diffuse, diffuse[0], diffuse[1], diffuse[2], diffuse[3]);
+    glExt.Uniform4f(instanceProgram.specular, 0.5f, 0.5f, 0.5f, 1.0f);
+    glExt.Uniform1f(instanceProgram.shininess, 50.0f);
+}
+
+void Renderer::setInstanceEdges(float size, float r, float g, float b) {
+    glExt.Uniform1f(instanceProgram.scale, size);
+    glExt.Uniform1i(instanceProgram.lit, GL_FALSE);
+    glExt.Uniform3f(instanceProgram.edgeColor, r, g, b);
+}
+
+bool Renderer::visible(float x, float y, float z, float radius, CullStats& counter) {
+    bool inside = frustum.containsSphere(x, y, z, radius);
+    (inside ? counter.drawn : counter.culled)++;
+    return inside;
+}
+
+void Renderer::applyMaterial(uint8_t material) {
+    if (material == currentMaterial) return;
+    const MaterialState& next = MATERIALS[material];
+
+    if (next.program != programOn) {
+        glExt.UseProgram(next.program ? instanceProgram.program : 0);
+        programOn = next.program;
+        stats.stateChanges++;
+    }
+    if (next.lighting != lightingOn) {
+        (next.lighting ? glEnable : glDisable)(GL_LIGHTING);
+        lightingOn = next.lighting;
+        stats.stateChanges++;
+    }
+    if (next.colorMaterial != colorMaterialOn) {
+        (next.colorMaterial ? glEnable : glDisable)(GL_COLOR_MATERIAL);
+        colorMaterialOn = next.colorMaterial;
+        stats.stateChanges++;
+    }
+    if (next.lighting) {
+        // With color material on, the current color stands in for ambient and diffuse
+        if (!next.colorMaterial) {
+            glMaterialfv(GL_FRONT, GL_AMBIENT, next.ambient);
+            glMaterialfv(GL_FRONT, GL_DIFFUSE, next.diffuse);
+        }
+        glMaterialfv(GL_FRONT, GL_SPECULAR, next.specular);
+        glMaterialf(GL_FRONT, GL_SHININESS, next.shininess);
+        stats.stateChanges++;
+    }
+    currentMaterial = material;
+}
+
+void Renderer::setColor(const float* color) {
+    if (colorValid && std::equal(color, color + 4, currentColor)) return;
+    glColor4fv(color);
+    std::copy(color, color + 4, currentColor);
+    colorValid = true;
+    stats.stateChanges++;
+}
+
+void Renderer::drawShape(uint8_t shape) {
+    bool retained = activeBackend == RenderBackend::RETAINED;
+    switch (shape) {
+    case SHAPE_CUBE:
+        if (retained) drawMesh(cubeMesh); else glutSolidCube(1.0f);
+        break;
+    case SHAPE_WIRE_CUBE:
+        if (retained) drawMesh(wireCubeMesh); else glutWireCube(1.0f);
+        break;
+    case SHAPE_CONE:
+        if (retained) drawMesh(coneMesh);
+        else glutSolidCone(ARROW_CONE_BASE, ARROW_CONE_HEIGHT, ARROW_CONE_SLICES, ARROW_CONE_STACKS);
+        break;
+    case SHAPE_SKY:
+        if (retained) drawMesh(skyMesh); else glutSolidSphere(SKY_RADIUS, SKY_SLICES, SKY_STACKS);
+        break;
+    case SHAPE_CLOUD:
+    case SHAPE_CLOUD_MEDIUM:
+    case SHAPE_CLOUD_LOW:
+    {
+        int lod = shape - SHAPE_CLOUD;
+        if (retained) drawMesh(cloudMeshes[lod]);
+        else glutSolidSphere(CLOUD_RADIUS, CLOUD_LODS[lod].slices, CLOUD_LODS[lod].stacks);
+        break;
+    }
+    case SHAPE_GRID:
+        drawGrid();
+        break;
+    }
+}
+
+void Renderer::drawBatch(const DrawCommand& command) {
+    // With color material on, the tile color is both ambient and diffuse
+    static const GLfloat tileColor[] = { 0.3f, 0.3f, 0.5f, 1.0f };
+    static const GLfloat obstacleAmbient[] = { 0.3f, 0.0f, 0.0f, 1.0f };
+    static const GLfloat obstacleDiffuse[] = { 1.0f, 0.0f, 0.0f, 1.0f };
+
+    switch (command.shape) {
+    case SHAPE_TILE_BATCH:
+        setInstanceMaterial(Game::CUBE_SIZE, tileColor, tileColor);
+        drawInstanced(cubeMesh, command.firstInstance, command.instanceCount);
+        break;
+    case SHAPE_TILE_EDGE_BATCH:
+        setInstanceEdges(Game::CUBE_SIZE * TILE_EDGE_SCALE, 0.0f, 0.0f, 0.0f);
+        drawInstanced(wireCubeMesh, command.firstInstance, command.instanceCount);
+        break;
+    case SHAPE_OBSTACLE_BATCH:
+        setInstanceMaterial(OBSTACLE_SIZE, obstacleAmbient, obstacleDiffuse);
+        drawInstanced(cubeMesh, command.firstInstance, command.instanceCount);
+        break;
+    case SHAPE_OBSTACLE_EDGE_BATCH:
+        setInstanceEdges(OBSTACLE_EDGE_SIZE, 0.5f, 0.0f, 0.0f);
+        drawInstanced(wireCubeMesh, command.firstInstance, command.instanceCount);
+        break;
+    }
+}
+
+void Renderer::executeDrawList() {
+    drawList.sort();
+    if (!instances.empty()) uploadInstances();
+
+    // Start from a known state; from here on only differences are sent
+    glEnable(GL_LIGHTING);
+    glEnable(GL_COLOR_MATERIAL);
+    lightingOn = colorMaterialOn = true;
+    programOn = false;
+    colorValid = false;
+    currentMaterial = MATERIAL_NONE;
+
+    bool viewLoaded = true;
+    for (const DrawCommand& command : drawList.commands()) {
+#ifdef CROSSY_PROFILE
+        if (!spanOpen || command.phase != static_cast<uint8_t>(spanPhase)) {
+            beginSpan(static_cast<ProfilePhase>(command.phase));
+        }
+#endif
+        applyMaterial(command.material);
+        if (MATERIALS[command.material].program) {
+            if (!viewLoaded) {
+                glLoadMatrixf(view.m);
+                viewLoaded = true;
+            }
+            drawBatch(command);
+            continue;
+        }
+
+        if (!MATERIALS[command.material].lighting || MATERIALS[command.material].colorMaterial) {
+            setColor(command.color);
+        }
+        glLoadMatrixf((view * command.model).m);
+        viewLoaded = false;
+        drawShape(command.shape);
+        // The grid's vertex colors leave the current color undefined
+        if (command.shape == SHAPE_GRID) colorValid = false;
+    }
+    stats.commands = static_cast<int>(drawList.commands().size());
+
+    applyMaterial(MATERIAL_DEFAULT);
+    glLoadMatrixf(view.m);
+    endSpan();
+}
+
+void Renderer::collectTiles(const Game& game) {
+    static const float tileColor[] = { 0.3f, 0.3f, 0.5f, 1.0f };
+    float tileRadius = game.CUBE_SIZE * TILE_EDGE_SCALE * CUBE_RADIUS_PER_SIZE;
+
+    if (!instancing()) {
+        Mat4 scale = Mat4::scaling(game.CUBE_SIZE, game.CUBE_SIZE, game.CUBE_SIZE);
+        float edgeSize = game.CUBE_SIZE * TILE_EDGE_SCALE;
+        Mat4 edgeScale = Mat4::scaling(edgeSize, edgeSize, edgeSize);
+        for (size_t i = 0; i < game.path.size(); ++i) {
+            float life = game.path.lifetime(i);
+            float x = static_cast<float>(game.path.x(i));
+            float z = static_cast<float>(game.path.z(i));
+            if (life <= 0.0f || !visible(x, 0.0f, z, tileRadius, stats.tiles)) continue;
+
+            float alpha = life / game.path.maxLifetime(i);
+            // A fading tile used to get its outline drawn twice; keep that darker edge
+            float edgeAlpha = 1.0f - (1.0f - alpha) * (1.0f - alpha);
+            const float color[] = { tileColor[0], tileColor[1], tileColor[2], alpha };
+            const float edgeColor[] = { 0.0f, 0.0f, 0.0f, edgeAlpha };
+            Mat4 position = Mat4::translation(x, 0.0f, z);
+            if (alpha >= 1.0f) {
+                drawList.addOpaque(MAT_COLORED, SHAPE_CUBE, position * scale, color);
+                drawList.addOpaque(MAT_COLORED, SHAPE_WIRE_CUBE, position * edgeScale, edgeColor);
+            }
+            else {
+                float depth = frustum.depth(x, 0.0f, z);
+                drawList.addTransparent(depth, MAT_COLORED, SHAPE_CUBE, position * scale, color);
+                drawList.addTransparent(depth, MAT_COLORED, SHAPE_WIRE_CUBE, position * edgeScale, edgeColor);
+            }
+        }
+        return;
+    }
+
+    // Opaque tiles first, then fading ones, each range one instanced batch
+    uint32_t opaqueStart = static_cast<uint32_t>(instances.size());
+    for (size_t i = 0; i < game.path.size(); ++i) {
+        float life = game.path.lifetime(i);
+        float x = static_cast<float>(game.path.x(i));
+        float z = static_cast<float>(game.path.z(i));
+        if (life <= 0.0f || !visible(x, 0.0f, z, tileRadius, stats.tiles)) continue;
+
+        float alpha = life / game.path.maxLifetime(i);
+        float edgeAlpha = 1.0f - (1.0f - alpha) * (1.0f - alpha);
+        instances.push_back({ x, 0.0f, z, 0.0f, alpha, edgeAlpha });
+    }
+    auto begin = instances.begin() + opaqueStart;
+    auto fadingBegin = std::partition(begin, instances.end(), [](const Instance& t) { return t.alpha >= 1.0f; });
+    std::sort(fadingBegin, instances.end(), [this](const Instance& a, const Instance& b) {
+        return frustum.depth(a.x, a.y, a.z) > frustum.depth(b.x, b.y, b.z);
+    });
+
+    uint32_t fadingStart = static_cast<uint32_t>(fadingBegin - instances.begin());
+    uint32_t end = static_cast<uint32_t>(instances.size());
+    Mat4 identity = Mat4::identity();
+    if (fadingStart > opaqueStart) {
+        drawList.addOpaque(MAT_INSTANCED, SHAPE_TILE_BATCH, identity, tileColor, opaqueStart, fadingStart - opaqueStart);
+        drawList.addOpaque(MAT_INSTANCED, SHAPE_TILE_EDGE_BATCH, identity, tileColor, opaqueStart,
+            fadingStart - opaqueStart);
+    }
+    if (end > fadingStart) {
+        // Sorted within the batch; the batch itself goes behind every other transparent draw
+        float depth = frustum.depth(instances[fadingStart].x, 0.0f, instances[fadingStart].z);
+        drawList.addTransparent(depth, MAT_INSTANCED, SHAPE_TILE_BATCH, identity, tileColor, fadingStart,
+            end - fadingStart);
+        drawList.addTransparent(depth, MAT_INSTANCED, SHAPE_TILE_EDGE_BATCH, identity, tileColor, fadingStart,
+            end - fadingStart);
+    }
+}
+
+void Renderer::collectObstacles(const Game& game, double obstacleTime) {
+    static const float white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    static const float edgeColor[] = { 0.5f, 0.0f, 0.0f, 1.0f };  // Dark red wireframe
+    // Culled by the sphere around everywhere the obstacle's type can move it, so
+    // only visible ones have their pose evaluated
+    const float cubeRadius = OBSTACLE_EDGE_SIZE * CUBE_RADIUS_PER_SIZE;
+    Mat4 scale = Mat4::scaling(OBSTACLE_SIZE, OBSTACLE_SIZE, OBSTACLE_SIZE);
+    Mat4 edgeScale = Mat4::scaling(OBSTACLE_EDGE_SIZE, OBSTACLE_EDGE_SIZE, OBSTACLE_EDGE_SIZE);
+
+    for (ObstacleBucket& bucket : obstacleBuckets) bucket.clear();
+    for (const Game::Obstacle& obstacle : game.obstacles) {
+        if (!obstacle.active) continue;
+        float radius = cubeRadius + OBSTACLE_MOTION_RADII[obstacle.type];
+        if (!visible(float(obstacle.x), 1.0f, float(obstacle.z), radius, stats.obstacles)) continue;
+        float age = static_cast<float>(std::max(0.0, obstacleTime - obstacle.spawnTime));
+        obstacleBuckets[obstacle.type - 1].push_back(obstacle.x, obstacle.z, age);
+    }
+
+    uint32_t start = static_cast<uint32_t>(instances.size());
+    for (size_t type = 0; type < ObstacleTypes::COUNT; ++type) {
+        ObstacleBucket& bucket = obstacleBuckets[type];
+        bucket.preparePoses();
+        obstacleKernels->kernels[type](bucket, 0);
+
+        for (size_t i = 0; i < bucket.size(); ++i) {
+            float x = bucket.x[i] + bucket.offsetX[i], y = bucket.height[i], z = bucket.z[i] + bucket.offsetZ[i];
+            float rotation = bucket.rotation[i];
+            if (instancing()) {
+                instances.push_back({ x, y, z, rotation * static_cast<float>(M_PI) / 180.0f, 1.0f, 1.0f });
+                continue;
+            }
+            Mat4 model = Mat4::translation(x, y, z) * Mat4::rotation(rotation, 0, 1, 0);
+            drawList.addOpaque(MAT_OBSTACLE, SHAPE_CUBE, model * scale, white);
+            drawList.addOpaque(MAT_UNLIT, SHAPE_WIRE_CUBE, model * edgeScale, edgeColor);
+        }
+    }
+
+    uint32_t end = static_cast<uint32_t>(instances.size());
+    if (end > start) {
+        Mat4 identity = Mat4::identity();
+        drawList.addOpaque(MAT_INSTANCED, SHAPE_OBSTACLE_BATCH, identity, white, start, end - start);
+        drawList.addOpaque(MAT_INSTANCED, SHAPE_OBSTACLE_EDGE_BATCH, identity, white, start, end - start);
+    }
+}
+
+void Renderer::collectArrow(float x, float y, float z, int direction) {
+    static const float white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float turn = 0.0f;
+    char key = ' ';
+    switch (direction) {
+    case 1: turn = 180.0f; key = 'W'; break;
+    case 2: turn = 0.0f; key = 'S'; break;
+    case 3: turn = 90.0f; key = 'A'; break;
+    case 4: turn = -90.0f; key = 'D'; break;
+    }
+
+    Mat4 base = Mat4::translation(x, y, z) * Mat4::rotation(turn, 0, 1, 0);
+    drawList.addOpaque(MAT_ARROW, SHAPE_CUBE, base * Mat4::scaling(0.1f, 0.1f, 0.4f), white);
+    drawList.addOpaque(MAT_ARROW, SHAPE_CONE,
+        base * Mat4::translation(0, 0, 0.25f) * Mat4::rotation(-90, 1, 0, 0), white);
+
+    // The key letter sits above the arrow's origin, which the turn does not move
+    labels[labelCount++] = { x, y + 0.2f, z, key };
+}
+
+void Renderer::collectPlayer(const Game& game, const PlayerPose& pose) {
+    static const float white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    static const float edgeColor[] = { 0.0f, 0.3f, 0.0f, 1.0f };  // Dark green wireframe
+
+    Mat4 model;
+    if (pose.isJumping) {
+        model = Mat4::translation(pose.x, pose.y + pose.jumpHeight, pose.z);
+        float rotationAngle = pose.jumpProgress * 180.0f;
+
+        switch (pose.rollDirection) {
+        case 1: model = model * Mat4::rotation(-rotationAngle, 1.0f, 0.0f, 0.0f); break;
+        case 2: model = model * Mat4::rotation(rotationAngle, 1.0f, 0.0f, 0.0f); break;
+        case 3: model = model * Mat4::rotation(rotationAngle, 0.0f, 0.0f, 1.0f); break;
+        case 4: model = model * Mat4::rotation(-rotationAngle, 0.0f, 0.0f, 1.0f); break;
+        }
+    }
+    else if (pose.isRolling) {
+        model = Mat4::translation(pose.x, pose.y, pose.z);
+
+        // Roll about the bottom edge on the side the cube is moving towards
+        switch (pose.rollDirection) {
+        case 1:
+            model = model * Mat4::translation(0, -0.5f, -0.5f) * Mat4::rotation(-pose.rollAngle, 1.0f, 0.0f, 0.0f)
+                * Mat4::translation(0, 0.5f, 0.5f);
+            break;
+        case 2:
+            model = model * Mat4::translation(0, -0.5f, 0.5f) * Mat4::rotation(pose.rollAngle, 1.0f, 0.0f, 0.0f)
+                * Mat4::translation(0, 0.5f, -0.5f);
+            break;
+        case 3:
+            model = model * Mat4::translation(-0.5f, -0.5f, 0) * Mat4::rotation(pose.rollAngle, 0.0f, 0.0f, 1.0f)
+                * Mat4::translation(0.5f, 0.5f, 0);
+            break;
+        case 4:
+            model = model * Mat4::translation(0.5f, -0.5f, 0) * Mat4::rotation(-pose.rollAngle, 0.0f, 0.0f, 1.0f)
+                * Mat4::translation(-0.5f, 0.5f, 0);
+            break;
+        }
+    }
+    else {
+        model = Mat4::translation(pose.x, pose.y, pose.z);
+    }
+
+    float size = game.CUBE_SIZE, edgeSize = game.CUBE_SIZE * TILE_EDGE_SCALE;
+    drawList.addOpaque(MAT_PLAYER, SHAPE_CUBE, model * Mat4::scaling(size, size, size), white);
+    drawList.addOpaque(MAT_UNLIT, SHAPE_WIRE_CUBE, model * Mat4::scaling(edgeSize, edgeSize, edgeSize), edgeColor);
+
+    if (!pose.isRolling && !pose.isJumping && !game.gameOver && game.showDirections) {
+        collectArrow(pose.x, pose.y + 0.7f, pose.z - 1.0f, 1);
+        collectArrow(pose.x, pose.y + 0.7f, pose.z + 1.0f, 2);
+        collectArrow(pose.x - 1.0f, pose.y + 0.7f, pose.z, 3);
+        collectArrow(pose.x + 1.0f, pose.y + 0.7f, pose.z, 4);
+    }
+}
+
+void Renderer::collectSky(const PlayerPose& pose) {
+    static const float skyColor[] = { 0.2f, 0.4f, 0.8f, 1.0f };
+    static const float cloudColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    static const float white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    if (skyMode == SkyMode::DOME) {
+        drawList.addOpaque(MAT_UNLIT, SHAPE_SKY, Mat4::translation(pose.x, 0.0f, pose.z), skyColor);
+    }
+    for (int i = 0; i < 10; i++) {
+        float x = pose.x + (i * 10 - 50), y = 15.0f, z = pose.z + (i % 3 * 10 - 15);
+        if (visible(x, y, z, CLOUD_RADIUS, stats.props)) {
+            float depth = frustum.depth(x, y, z);
+            int lod = 0;
+            while (lod + 1 < CLOUD_LOD_COUNT && depth > CLOUD_LODS[lod].maxDepth) ++lod;
+            drawList.addOpaque(MAT_UNLIT, static_cast<uint8_t>(SHAPE_CLOUD + lod), Mat4::translation(x, y, z),
+                cloudColor);
+        }
+    }
+    drawList.setPhase(static_cast<uint8_t>(ProfilePhase::GRID));
+    drawList.addOpaque(MAT_COLORED, SHAPE_GRID, Mat4::identity(), white);
+}
+
+// Screen-filling strip in the fog color up to the middle of the screen, shading to
+// a slightly deeper blue at the top. The sky dome sits past the fog end, so it
+// shows as plain fog color; this keeps the horizon matching the fogged scene
+// without drawing the sphere.
+void Renderer::drawSkyGradient() {
+    static const GLfloat corners[] = { -1, -1, 1, -1, -1, 0, 1, 0, -1, 1, 1, 1 };
+    static const GLfloat colors[] = {
+        0.2f, 0.3f, 0.4f, 0.2f, 0.3f, 0.4f,
+        0.2f, 0.3f, 0.4f, 0.2f, 0.3f, 0.4f,
+        0.14f, 0.24f, 0.45f, 0.14f, 0.24f, 0.45f
+    };
+
+    beginSpan(ProfilePhase::SKY);
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_FOG);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, corners);
+    glColorPointer(3, GL_FLOAT, 0, colors);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glEnable(GL_FOG);
+    glEnable(GL_LIGHTING);
+    glEnable(GL_DEPTH_TEST);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    endSpan();
+}
+
+void Renderer::drawGrid() {
+    // Lines carry no normal of their own; give both backends the same one
+    glNormal3f(0.0f, 1.0f, 0.0f);
+    if (activeBackend == RenderBackend::RETAINED) {
+        drawMesh(gridMesh);
+        return;
+    }
+
+    glBegin(GL_LINES);
+    for (int i = -GRID_HALF_EXTENT; i <= GRID_HALF_EXTENT; i++) {
+        float alpha = 1.0f - (abs(i) / static_cast<float>(GRID_HALF_EXTENT));
+        glColor3f(0.3f * alpha, 0.3f * alpha, 0.3f * alpha);
+
+        glVertex3f(i, GRID_Y, -GRID_HALF_EXTENT);
+        glVertex3f(i, GRID_Y, GRID_HALF_EXTENT);
+
+        glVertex3f(-GRID_HALF_EXTENT, GRID_Y, i);
+        glVertex3f(GRID_HALF_EXTENT, GRID_Y, i);
+    }
+    glEnd();
+}
+
+void Renderer::drawLabels() {
+    if (!useGlut || labelCount == 0) return;
+    beginSpan(ProfilePhase::LABELS);
+    glDisable(GL_LIGHTING);
+    glColor3f(0.0f, 0.0f, 0.0f);
+    for (int i = 0; i < labelCount; ++i) {
+        glRasterPos3f(labels[i].x, labels[i].y, labels[i].z);
+        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, labels[i].key);
+    }
+    glEnable(GL_LIGHTING);
+    endSpan();
+}
+
+void Renderer::beginSpan(ProfilePhase phase) {
+#ifdef CROSSY_PROFILE
+    endSpan();
+    spanPhase = phase;
+    spanStart = Profiler::nowNs();
+    spanOpen = true;
+    gpuTimer.begin(phase);
+#else
+    (void)phase;
+#endif
+}
+
+void Renderer::endSpan() {
+#ifdef CROSSY_PROFILE
+    if (!spanOpen) return;
+    gpuTimer.end();
+    profiler.record(spanPhase, false, spanStart, Profiler::nowNs() - spanStart);
+    spanOpen = false;
+#endif
+}
+
+void Renderer::toggleProfilerOverlay() {
+    if (!Profiler::COMPILED_IN) {
+        std::cerr << "Profiler not compiled in; rebuild with -DCROSSY_PROFILE" << std::endl;
+        return;
+    }
+    showProfiler = !showProfiler;
+    profilerFrame = 0;
+}
+
+static const char* PROFILE_HEADER = "ms       CPU min / avg / p99     GPU avg / p99";
+
+// Summarizes the newest events; refreshed every few frames so the numbers stay readable
+void Renderer::updateProfileLines() {
+    static const size_t WINDOW_EVENTS = 8192;
+    static const int REFRESH_FRAMES = 30;
+    if (profilerFrame++ % REFRESH_FRAMES != 0) return;
+
+    PhaseSummary cpu[static_cast<int>(ProfilePhase::COUNT)], gpu[static_cast<int>(ProfilePhase::COUNT)];
+    profiler.summarize(WINDOW_EVENTS, cpu, gpu);
+
+    char line[80];
+    profileLines[0] = PROFILE_HEADER;
+    for (int phase = 0; phase < static_cast<int>(ProfilePhase::COUNT); ++phase) {
+        const char* name = profilePhaseName(static_cast<ProfilePhase>(phase));
+        if (gpu[phase].samples > 0) {
+            std::snprintf(line, sizeof(line), "%s: %.2f / %.2f / %.2f    %.2f / %.2f", name,
+                cpu[phase].minMs, cpu[phase].avgMs, cpu[phase].p99Ms, gpu[phase].avgMs, gpu[phase].p99Ms);
+        }
+        else {
+            std::snprintf(line, sizeof(line), "%s: %.2f / %.2f / %.2f", name,
+                cpu[phase].minMs, cpu[phase].avgMs, cpu[phase].p99Ms);
+        }
+        profileLines[1 + phase] = line;
+        if (hud.ready()) hud.setText(hudProfile[1 + phase], line);
+    }
+}
+
+void Renderer::drawProfileOverlay() {
+    if (hud.ready()) {
+        hud.setVisible(hudProfileBackdrop, showProfiler);
+        for (int field : hudProfile) hud.setVisible(field, showProfiler);
+        if (showProfiler) updateProfileLines();
+        return;
+    }
+    if (!showProfiler || !useGlut) return;
+
+    updateProfileLines();
+    glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
+    glBegin(GL_QUADS);
+    glVertex2f(0, 210);
+    glVertex2f(520, 210);
+    glVertex2f(520, 0);
+    glVertex2f(0, 0);
+    glEnd();
+    for (int i = 0; i < PROFILE_LINES; ++i) {
+        drawText(10, 190 - 18.0f * i, profileLines[i], 0.6f, 1.0f, 0.6f);
+    }
+}
+
+static const char* CAMERA_MODE_NAMES[] = { "Isometric", "Top-down", "Side view", "First-person" };
+
+void Renderer::initHud() {
+    if (!hud.init(GLUT_BITMAP_HELVETICA_18)) return;
+
+    static const float backdrop[] = { 0.0f, 0.0f, 0.0f, 0.5f };
+    static const float yellow[] = { 1.0f, 1.0f, 0.0f }, red[] = { 1.0f, 0.0f, 0.0f }, white[] = { 1.0f, 1.0f, 1.0f };
+    hud.addRect(0, 450, 450, 600, backdrop);
+    hudScore = hud.addText(10, 580, yellow, 24);
+    hudGameOver = hud.addText(300, 300, red, 32, "Game Over! Press R to Restart");
+    hudControls[0] = hud.addText(10, 560, white, 56, "Controls: W/A/S/D to roll, SPACE+Direction to jump");
+    hudControls[1] = hud.addText(10, 540, white, 32, "Press V to change camera view");
+    hudControls[2] = hud.addText(10, 520, white, 40, "Press C to toggle camera rotation");
+    hudCamera = hud.addText(10, 500, white, 24);
+    hudRotation = hud.addText(10, 480, white, 32);
+
+    if (Profiler::COMPILED_IN) {
+        static const float green[] = { 0.6f, 1.0f, 0.6f };
+        hudProfileBackdrop = hud.addRect(0, 0, 520, 210, backdrop);
+        hudProfile[0] = hud.addText(10, 190, green, 48, PROFILE_HEADER);
+        for (int i = 1; i < PROFILE_LINES; ++i) {
+            hudProfile[i] = hud.addText(10, 190 - 18.0f * i, green, 56);
+        }
+        hud.setVisible(hudProfileBackdrop, false);
+        for (int field : hudProfile) hud.setVisible(field, false);
+    }
+}
+
+// Reformats only the fields whose values changed since the last frame
+void Renderer::updateHud(const Game& game) {
+    char line[32];
+    if (game.score != shownScore) {
+        shownScore = game.score;
+        std::snprintf(line, sizeof(line), "Score: %d", game.score);
+        hud.setText(hudScore, line);
+    }
+    if (game.cameraMode != shownCameraMode) {
+        shownCameraMode = game.cameraMode;
+        std::snprintf(line, sizeof(line), "Camera: %s", CAMERA_MODE_NAMES[game.cameraMode & 3]);
+        hud.setText(hudCamera, line);
+    }
+    if (static_cast<int>(game.fixedCameraAngle) != shownFixedCamera) {
+        shownFixedCamera = game.fixedCameraAngle;
+        hud.setText(hudRotation, game.fixedCameraAngle ? "Camera Rotation: Fixed" : "Camera Rotation: Rotating");
+    }
+
+    // Setting visibility is a no-op unless it flips
+    hud.setVisible(hudGameOver, game.gameOver);
+    for (int field : hudControls) hud.setVisible(field, !game.gameOver);
+    hud.setVisible(hudCamera, !game.gameOver);
+    hud.setVisible(hudRotation, !game.gameOver);
+}
+
+void Renderer::drawText(float x, float y, const std::string& text, float r, float g, float b) {
+    glColor3f(r, g, b);
+    glRasterPos2f(x, y);
+    for (const char c : text) {
+        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+    }
+}
+
+void Renderer::drawHud(const Game& game) {
+    // One orthographic setup and one set of state changes for the whole overlay
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, 800, 0, 600);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glDisable(GL_DEPTH_TEST);  // Disable depth testing for UI elements
+    glDisable(GL_LIGHTING);
+    beginSpan(ProfilePhase::HUD);
+    if (hud.ready()) {
+        updateHud(game);
+        if (Profiler::COMPILED_IN) drawProfileOverlay();
+        hud.draw();
+    }
+    else {
+        glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
+        glBegin(GL_QUADS);
+        glVertex2f(0, 600);
+        glVertex2f(450, 600);
+        glVertex2f(450, 450);
+        glVertex2f(0, 450);
+        glEnd();
+
+        if (useGlut) {
+            drawText(10, 580, "Score: " + std::to_string(game.score), 1.0f, 1.0f, 0.0f);
+
+            if (game.gameOver) {
+                drawText(300, 300, "Game Over! Press R to Restart", 1.0f, 0.0f, 0.0f);
+            }
+            else {
+                drawText(10, 560, "Controls: W/A/S/D to roll, SPACE+Direction to jump", 1.0f, 1.0f, 1.0f);
+                drawText(10, 540, "Press V to change camera view", 1.0f, 1.0f, 1.0f);
+                drawText(10, 520, "Press C to toggle camera rotation", 1.0f, 1.0f, 1.0f);
+
+                drawText(10, 500, std::string("Camera: ") + CAMERA_MODE_NAMES[game.cameraMode & 3], 1.0f, 1.0f, 1.0f);
+                drawText(10, 480, "Camera Rotation: " + std::string(game.fixedCameraAngle ? "Fixed" : "Rotating"), 1.0f, 1.0f, 1.0f);
+            }
+        }
+        if (Profiler::COMPILED_IN) drawProfileOverlay();
+    }
+    endSpan();
+
+    glEnable(GL_LIGHTING);
+    glEnable(GL_DEPTH_TEST);
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void Renderer::drawFrame(const Game& game, const PlayerPose& pose, double obstacleTime) {
+    PROFILE_SCOPE(ProfilePhase::FRAME);
+    if (Profiler::COMPILED_IN) gpuTimer.beginFrame();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glLoadIdentity();
+
+    float camX, camY, camZ;
+    float lookX, lookY, lookZ;
+    float upX = 0, upY = 1, upZ = 0;
+
+    float playerViewY = pose.y + pose.jumpHeight;
+
+    switch (game.cameraMode) {
+    case 0:
+        camX = pose.x + game.cameraDistance * cos(game.cameraAngle * M_PI / 180.0f);
+        camY = playerViewY + game.cameraDistance * 0.7f;
+        camZ = pose.z + game.cameraDistance * sin(game.cameraAngle * M_PI / 180.0f);
+        lookX = pose.x;
+        lookY = playerViewY;
+        lookZ = pose.z;
+        break;
+    case 1:
+        camX = pose.x;
+        camY = playerViewY + game.cameraDistance;
+        camZ = pose.z;
+        lookX = pose.x;
+        lookY = playerViewY;
+        lookZ = pose.z;
+        upX = 1; upY = 0; upZ = 0;
+        break;
+    case 2:
+        camX = pose.x + game.cameraDistance;
+        camY = playerViewY;
+        camZ = pose.z;
+        lookX = pose.x;
+        lookY = playerViewY;
+        lookZ = pose.z;
+        break;
+    default:
+        camX = pose.x;
+        camY = playerViewY + 3.0f;
+        camZ = pose.z + 5.0f;
+        lookX = pose.x;
+        lookY = playerViewY;
+        lookZ = pose.z - 5.0f;
+        break;
+    }
+
+    gluLookAt(camX, camY, camZ, lookX, lookY, lookZ, upX, upY, upZ);
+
+    // Past the fog end everything is drawn in the fog color, the same as the sky
+    // dome behind it, so the fog end doubles as the draw distance
+    GLfloat projection[16];
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetFloatv(GL_MODELVIEW_MATRIX, view.m);
+    frustum.extract(projection, view.m);
+    frustum.limitDepth(FOG_END);
+    stats = FrameStats();
+
+    // Collect the scene, then draw it sorted by state
+    {
+        PROFILE_SCOPE(ProfilePhase::COLLECT);
+        drawList.clear();
+        instances.clear();
+        labelCount = 0;
+        drawList.setPhase(static_cast<uint8_t>(ProfilePhase::SKY));
+        collectSky(pose);
+        drawList.setPhase(static_cast<uint8_t>(ProfilePhase::TILES));
+        collectTiles(game);
+        drawList.setPhase(static_cast<uint8_t>(ProfilePhase::OBSTACLES));
+        collectObstacles(game, obstacleTime);
+        if (!game.gameOver) {
+            drawList.setPhase(static_cast<uint8_t>(ProfilePhase::PLAYER));
+            collectPlayer(game, pose);
+        }
+    }
+    if (skyMode == SkyMode::GRADIENT) {
+        drawSkyGradient();
+    }
+    executeDrawList();
+    drawLabels();
+
+    drawHud(game);
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "DrawList.h"
+#include "Frustum.h"
+#include "GLExtensions.h"
+#include "Game.h"
+#include "GpuTimer.h"
+#include "HudText.h"
+#include "Meshes.h"
+#include "ObstacleKernels.h"
+#include "Profiler.h"
+
+// How scene geometry reaches the GPU
+enum class RenderBackend {
+    IMMEDIATE,  // Fixed-function glBegin/glEnd and GLUT shapes, re-sent every frame
+    RETAINED    // Meshes uploaded once into vertex buffer objects; tiles and obstacles
+                // instanced when the context supports it
+};
+
+// What is drawn behind the scene
+enum class SkyMode {
+    DOME,     // Sky sphere around the player, with clouds
+    GRADIENT  // One screen-filling gradient quad and the clouds; the cheap fallback
+};
+
+// Player state as drawn this frame, blended between the last two simulation ticks
+struct PlayerPose {
+    float x, y, z;
+    float jumpHeight, jumpProgress, rollAngle;
+    int rollDirection;
+    bool isRolling, isJumping;
+};
+
+PlayerPose capturePose(const Game& g);
+
+// How many objects of one kind the last frame drew and how many it culled
+struct CullStats {
+    int drawn = 0, culled = 0;
+};
+
+struct FrameStats {
+    CullStats tiles, obstacles, props;  // Props are the clouds around the sky dome
+    int commands = 0;                   // Draw-list entries executed
+    int stateChanges = 0;               // Material, enable and color changes sent to GL
+};
+
+// Draws the game into the current OpenGL context. The renderer never touches the
+// simulation; the caller hands it the player pose and the game time at which to
+// show the obstacles for the frame.
+class Renderer {
+public:
+    // Sets up lights, fog and blending and, for the retained backend, uploads the
+    // static meshes. Falls back to immediate mode when buffer objects are missing.
+    // Without GLUT (offscreen contexts) text is skipped and buffer objects are required.
+    void init(RenderBackend requested, bool glutAvailable);
+    void resize(int width, int height);
+    void setSkyMode(SkyMode mode) { skyMode = mode; }
+    void drawFrame(const Game& game, const PlayerPose& pose, double obstacleTime);
+
+    RenderBackend backend() const { return activeBackend; }
+    bool instancing() const { return instanceProgram.program != 0; }
+    const FrameStats& frameStats() const { return stats; }
+
+    // Per-phase min / avg / p99 table in the bottom left corner (-DCROSSY_PROFILE builds)
+    void toggleProfilerOverlay();
+
+private:
+    struct GpuMesh {
+        GLuint vertexBuffer = 0, indexBuffer = 0;
+        GLenum primitive = GL_TRIANGLES;
+        GLsizei count = 0;
+        GLsizei stride = 0;
+        bool hasNormals = false, hasColors = false;
+    };
+
+    // One cube of an instanced batch
+    struct Instance {
+        float x, y, z, rotation;  // Translation, and rotation about y in radians
+        float alpha, edgeAlpha;   // Opacity of the solid cube and of its outline
+    };
+
+    // Shader that lights instanced cubes the way the fixed-function pipeline does
+    struct InstanceProgram {
+        GLuint program = 0;
+        GLint scale = -1, lit = -1, edgeColor = -1;
+        GLint ambient = -1, diffuse = -1, specular = -1, shininess = -1;
+    };
+
+    // Draw-list materials and shapes, in the order opaque draws are grouped
+    enum Material : uint8_t {
+        MAT_UNLIT, MAT_COLORED, MAT_OBSTACLE, MAT_PLAYER, MAT_ARROW, MAT_INSTANCED,
+        MATERIAL_NONE = 0xFF,
+        MATERIAL_DEFAULT = MAT_COLORED  // What the rest of the frame expects to find
+    };
+    enum Shape : uint8_t {
+        SHAPE_SKY, SHAPE_CLOUD, SHAPE_CLOUD_MEDIUM, SHAPE_CLOUD_LOW, SHAPE_GRID, SHAPE_CUBE, SHAPE_WIRE_CUBE, SHAPE_CONE,
+        SHAPE_TILE_BATCH, SHAPE_TILE_EDGE_BATCH, SHAPE_OBSTACLE_BATCH, SHAPE_OBSTACLE_EDGE_BATCH
+    };
+
+    // Key letter drawn over a direction arrow
+    struct ArrowLabel {
+        float x, y, z;
+        char key;
+    };
+
+    bool useGlut = true;
+    static constexpr int CLOUD_LOD_COUNT = 3;  // SHAPE_CLOUD to SHAPE_CLOUD_LOW
+
+    RenderBackend activeBackend = RenderBackend::IMMEDIATE;
+    SkyMode skyMode = SkyMode::DOME;
+    GpuMesh cubeMesh, wireCubeMesh, skyMesh, cloudMeshes[CLOUD_LOD_COUNT], coneMesh, gridMesh;
+    InstanceProgram instanceProgram;
+    GLuint instanceBuffer = 0;
+    std::vector<Instance> instances;  // Reused every frame
+    // Visible obstacles packed by type, and the kernels that pose them
+    ObstacleBucket obstacleBuckets[ObstacleTypes::COUNT];
+    const ObstacleKernelSet* obstacleKernels = &selectObstacleKernels();
+    Frustum frustum;                  // Visible volume of the current frame, cut off at the fog end
+    Mat4 view = Mat4::identity();
+    DrawList drawList;
+    ArrowLabel labels[4];
+    int labelCount = 0;
+    FrameStats stats;
+
+    // Atlas HUD and its fields, with the values they currently show
+    HudText hud;
+    int hudScore = -1, hudGameOver = -1, hudControls[3] = { -1, -1, -1 }, hudCamera = -1, hudRotation = -1;
+    int shownScore = -1, shownCameraMode = -1, shownFixedCamera = -1;
+
+    // Profiler spans: consecutive draws of one phase share a CPU timer and a GPU query
+    static constexpr int PROFILE_LINES = 1 + static_cast<int>(ProfilePhase::COUNT);
+    GpuTimer gpuTimer;
+    bool spanOpen = false;
+    ProfilePhase spanPhase = ProfilePhase::FRAME;
+    uint64_t spanStart = 0;
+    bool showProfiler = false;
+    int profilerFrame = 0;
+    std::string profileLines[PROFILE_LINES];
+    int hudProfileBackdrop = -1, hudProfile[PROFILE_LINES] = {};
+
+    // State last sent to GL while executing the draw list
+    uint8_t currentMaterial = MATERIAL_NONE;
+    bool lightingOn = true, colorMaterialOn = true, programOn = false;
+    bool colorValid = false;
+    float currentColor[4] = {};
+
+    GpuMesh upload(const MeshData& mesh);
+    void drawMesh(const GpuMesh& mesh);
+    bool buildInstanceProgram();
+    void uploadInstances();
+    void drawInstanced(const GpuMesh& mesh, uint32_t first, uint32_t count);
+    void setInstanceMaterial(float size, const GLfloat* ambient, const GLfloat* diffuse);
+    void setInstanceEdges(float size, float r, float g, float b);
+    bool visible(float x, float y, float z, float radius, CullStats& counter);
+
+    // Scene collection, run before anything is drawn
+    void collectSky(const PlayerPose& pose);
+    void collectTiles(const Game& game);
+    void collectObstacles(const Game& game, double obstacleTime);
+    void collectPlayer(const Game& game, const PlayerPose& pose);
+    void collectArrow(float x, float y, float z, int direction);
+
+    // Draw-list execution, sending only the state that changes between commands
+    void executeDrawList();
+    void applyMaterial(uint8_t material);
+    void setColor(const float* color);
+    void drawShape(uint8_t shape);
+    void drawBatch(const DrawCommand& command);
+    void drawGrid();
+    void drawSkyGradient();
+    void drawLabels();
+
+    void beginSpan(ProfilePhase phase);
+    void endSpan();
+    void updateProfileLines();
+    void drawProfileOverlay();
+
+    void initHud();
+    void updateHud(const Game& game);
+    void drawText(float x, float y, const std::string& text, float r, float g, float b);
+    void drawHud(const Game& game);
+};
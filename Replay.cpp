@@ -0,0 +1,169 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+static const char REPLAY_MAGIC[4] = { 'C', 'R', 'R', 'P' };
+
+uint8_t inputMask(const Game& game) {
+    return static_cast<uint8_t>((game.keyW ? INPUT_W : 0) | (game.keyS ? INPUT_S : 0) | (game.keyA ? INPUT_A : 0)
+        | (game.keyD ? INPUT_D : 0) | (game.keySpace ? INPUT_SPACE : 0));
+}
+
+void applyInputMask(Game& game, uint8_t mask) {
+    game.keyW = (mask & INPUT_W) != 0;
+    game.keyS = (mask & INPUT_S) != 0;
+    game.keyA = (mask & INPUT_A) != 0;
+    game.keyD = (mask & INPUT_D) != 0;
+    game.keySpace = (mask & INPUT_SPACE) != 0;
+}
+
+static void putLittleEndian(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static uint64_t getLittleEndian(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// Returns false if the varint runs past end or does not fit 64 bits
+static bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && in < end; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+void saveReplay(const Replay& replay, const std::string& fileName) {
+    std::vector<uint8_t> header(REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    uint32_t tickRateBits;
+    std::memcpy(&tickRateBits, &replay.tickRate, sizeof(tickRateBits));
+    putLittleEndian(header, Replay::VERSION, 2);
+    putLittleEndian(header, 0, 2);
+    putLittleEndian(header, replay.seed, 8);
+    putLittleEndian(header, tickRateBits, 4);
+    putLittleEndian(header, replay.tickCount, 8);
+    putLittleEndian(header, replay.inputs.size(), 4);
+
+    std::ofstream out(fileName, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    out.write(reinterpret_cast<const char*>(replay.inputs.data()), replay.inputs.size());
+    if (!out) {
+        throw std::runtime_error("cannot write replay " + fileName);
+    }
+}
+
+Replay loadReplay(const std::string& fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open replay " + fileName);
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    const size_t headerSize = 32;
+    if (data.size() < headerSize || std::memcmp(data.data(), REPLAY_MAGIC, 4) != 0) {
+        throw std::runtime_error(fileName + " is not a replay");
+    }
+    if (getLittleEndian(&data[4], 2) != Replay::VERSION) {
+        throw std::runtime_error(fileName + " has an unsupported replay version");
+    }
+
+    Replay replay;
+    uint32_t tickRateBits = static_cast<uint32_t>(getLittleEndian(&data[16], 4));
+    replay.seed = getLittleEndian(&data[8], 8);
+    std::memcpy(&replay.tickRate, &tickRateBits, sizeof(tickRateBits));
+    replay.tickCount = getLittleEndian(&data[20], 8);
+    size_t inputSize = static_cast<size_t>(getLittleEndian(&data[28], 4));
+    if (data.size() != headerSize + inputSize || !(replay.tickRate > 0.0f)) {
+        throw std::runtime_error(fileName + " is truncated or corrupt");
+    }
+    replay.inputs.assign(data.begin() + headerSize, data.end());
+    return replay;
+}
+
+void ReplayRecorder::begin(uint64_t seed, float tickRate) {
+    current.seed = seed;
+    current.tickRate = tickRate;
+    current.tickCount = 0;
+    current.inputs.clear();
+    lastMask = 0;
+    lastChangeTick = 0;
+}
+
+void ReplayRecorder::record(uint8_t mask) {
+    if (mask != lastMask) {
+        putVarint(current.inputs, current.tickCount - lastChangeTick);
+        current.inputs.push_back(mask);
+        lastMask = mask;
+        lastChangeTick = current.tickCount;
+    }
+    current.tickCount++;
+}
+
+ReplayPlayer::ReplayPlayer(const Replay& replay, uint64_t snapshotInterval)
+    : source(replay), snapshotInterval(std::max<uint64_t>(snapshotInterval, 1)) {
+    const uint8_t* in = replay.inputs.data();
+    const uint8_t* end = in + replay.inputs.size();
+    uint64_t tick = 0, delta = 0;
+    while (in < end) {
+        if (!getVarint(in, end, delta) || in == end) {
+            throw std::runtime_error("corrupt replay input stream");
+        }
+        tick += delta;
+        changes.push_back({ tick, *in++ });
+    }
+    state.reset(replay.seed);
+}
+
+bool ReplayPlayer::step() {
+    if (finished()) return false;
+    if (currentTick % snapshotInterval == 0 && currentTick / snapshotInterval == snapshots.size()) {
+        snapshots.emplace_back();
+        snapshots.back().capture(state);
+    }
+    while (nextChange < changes.size() && changes[nextChange].tick <= currentTick) {
+        mask = changes[nextChange++].mask;
+    }
+    applyInputMask(state, mask);
+    state.updateGame(source.tickTime());
+    currentTick++;
+    return true;
+}
+
+void ReplayPlayer::run() {
+    while (step()) {
+    }
+}
+
+void ReplayPlayer::seek(uint64_t tick) {
+    tick = std::min(tick, source.tickCount);
+    if (!snapshots.empty()) {
+        uint64_t k = std::min<uint64_t>(tick / snapshotInterval, snapshots.size() - 1);
+        uint64_t snapshotTick = k * snapshotInterval;
+        // Restart from the snapshot if going back, or if it saves simulating ticks
+        if (tick < currentTick || snapshotTick > currentTick) {
+            snapshots[k].restore(state);
+            currentTick = snapshotTick;
+            auto next = std::lower_bound(changes.begin(), changes.end(), currentTick,
+                [](const Change& change, uint64_t t) { return change.tick < t; });
+            nextChange = static_cast<size_t>(next - changes.begin());
+            mask = nextChange > 0 ? changes[nextChange - 1].mask : 0;
+        }
+    }
+    while (currentTick < tick) step();
+}
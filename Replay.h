@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Game.h"
+#include "GameSnapshot.h"
+
+// Input bits of one simulation tick
+enum InputBit : uint8_t {
+    INPUT_W = 1 << 0,
+    INPUT_S = 1 << 1,
+    INPUT_A = 1 << 2,
+    INPUT_D = 1 << 3,
+    INPUT_SPACE = 1 << 4
+};
+
+uint8_t inputMask(const Game& game);
+void applyInputMask(Game& game, uint8_t mask);
+
+// One game as its seed, tick rate and per-tick input. Since a level is fully
+// determined by its seed and the simulation by its input, this is enough to
+// replay the game exactly.
+//
+// The input is delta encoded: for every change of the input mask, a LEB128
+// varint with the ticks since the previous change (the first counts from tick
+// 0), then the new mask byte. The mask starts out as 0.
+//
+// Files are little-endian: "CRRP", uint16 version, uint16 reserved, uint64
+// seed, float32 tick rate, uint64 tick count, uint32 input length, input bytes.
+struct Replay {
+    static constexpr uint16_t VERSION = 1;
+
+    uint64_t seed = 0;
+    float tickRate = 120.0f;
+    uint64_t tickCount = 0;
+    std::vector<uint8_t> inputs;
+
+    float tickTime() const { return static_cast<float>(1.0 / tickRate); }
+};
+
+// Throw std::runtime_error on I/O errors and malformed files
+void saveReplay(const Replay& replay, const std::string& fileName);
+Replay loadReplay(const std::string& fileName);
+
+// Appends ticks to a replay. A tick whose input matches the previous one costs
+// a compare and an increment; changes append two or three bytes.
+class ReplayRecorder {
+public:
+    void begin(uint64_t seed, float tickRate);
+    void record(uint8_t mask);
+    const Replay& replay() const { return current; }
+
+private:
+    Replay current;
+    uint8_t lastMask = 0;
+    uint64_t lastChangeTick = 0;
+};
+
+// Re-simulates a replay without a display. Every snapshotInterval ticks the
+// game state is saved the first time playback passes it, so seeking backwards
+// (or forwards past a saved point) restarts from the nearest snapshot instead
+// of from tick 0. The replay must outlive the player.
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(const Replay& replay, uint64_t snapshotInterval = 1200);
+
+    const Game& game() const { return state; }
+    uint64_t tick() const { return currentTick; }
+    bool finished() const { return currentTick >= source.tickCount; }
+
+    // Simulates one tick; returns false once the replay has run out
+    bool step();
+    // Plays to the end of the replay
+    void run();
+    // Moves to the state before the given tick is simulated (clamped to the end)
+    void seek(uint64_t tick);
+
+private:
+    struct Change {
+        uint64_t tick;
+        uint8_t mask;
+    };
+
+    const Replay& source;
+    uint64_t snapshotInterval;
+    std::vector<Change> changes;
+    std::vector<GameSnapshot> snapshots;  // snapshots[k] holds the state at tick k * snapshotInterval
+    Game state;
+    uint64_t currentTick = 0;
+    size_t nextChange = 0;
+    uint8_t mask = 0;
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+#include "ChunkPool.h"
+
+// FIFO window. Elements are appended at the back and retired from the front;
+// every element keeps an absolute sequence number (its position since the last
+// clear), so indices stored elsewhere stay valid while the front moves. Storage
+// is pooled 16-element chunks (ChunkWindow): elements never move, and once the
+// window has reached its working size, pushing and popping do not allocate.
+template <typename T>
+class RingBuffer {
+public:
+    static constexpr size_t CHUNK_ITEMS = 16;
+
+    struct Chunk {
+        static constexpr size_t SLOTS = CHUNK_ITEMS;
+        T items[SLOTS];
+        Chunk* nextFree;
+    };
+
+    explicit RingBuffer(size_t initialCapacity = 128) : window(initialCapacity) {}
+
+    size_t size() const { return window.size(); }
+    bool empty() const { return window.size() == 0; }
+    size_t capacity() const { return window.capacity(); }
+
+    // Sequence numbers of the first element and one past the last
+    uint64_t frontSeq() const { return window.frontSeq(); }
+    uint64_t endSeq() const { return window.endSeq(); }
+
+    void clear() { window.resetTo(0); }
+
+    void push_back(const T& value) {
+        atSeq(window.push()) = value;
+    }
+
+    void pop_front() { window.pop(); }
+
+    T& front() { return atSeq(frontSeq()); }
+    const T& front() const { return atSeq(frontSeq()); }
+    T& back() { return atSeq(endSeq() - 1); }
+    const T& back() const { return atSeq(endSeq() - 1); }
+
+    // Access by position in the window (0 = front)
+    T& operator[](size_t i) { return atSeq(frontSeq() + i); }
+    const T& operator[](size_t i) const { return atSeq(frontSeq() + i); }
+
+    // Access by absolute sequence number
+    T& atSeq(uint64_t seq) { return window.chunkAt(seq)->items[window.slotOf(seq)]; }
+    const T& atSeq(uint64_t seq) const { return window.chunkAt(seq)->items[window.slotOf(seq)]; }
+
+    template <typename Ring, typename Value>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        Iterator(Ring* ring, uint64_t seq) : ring(ring), seq(seq) {}
+        reference operator*() const { return ring->atSeq(seq); }
+        pointer operator->() const { return &ring->atSeq(seq); }
+        Iterator& operator++() { ++seq; return *this; }
+        bool operator==(const Iterator& other) const { return seq == other.seq; }
+        bool operator!=(const Iterator& other) const { return seq != other.seq; }
+
+    private:
+        Ring* ring;
+        uint64_t seq;
+    };
+
+    using iterator = Iterator<RingBuffer, T>;
+    using const_iterator = Iterator<const RingBuffer, const T>;
+
+    iterator begin() { return iterator(this, frontSeq()); }
+    iterator end() { return iterator(this, endSeq()); }
+    const_iterator begin() const { return const_iterator(this, frontSeq()); }
+    const_iterator end() const { return const_iterator(this, endSeq()); }
+
+    // Image for snapshots: head and count, then the items of each chunk holding
+    // live items as raw bytes. Only for trivially copyable items. Returns nullptr
+    // if the image would run past end.
+    size_t imageBytes() const { return 2 * sizeof(uint64_t) + window.chunkCount() * sizeof(Chunk::items); }
+
+    uint8_t* saveImage(uint8_t* out) const {
+        static_assert(std::is_trivially_copyable<T>::value, "ring images are raw copies");
+        uint64_t header[2] = { frontSeq(), size() };
+        std::memcpy(out, header, sizeof(header));
+        out += sizeof(header);
+        window.forEachChunk([&](Chunk* chunk) {
+            std::memcpy(out, chunk->items, sizeof(chunk->items));
+            out += sizeof(chunk->items);
+        });
+        return out;
+    }
+
+    const uint8_t* loadImage(const uint8_t* in, const uint8_t* end) {
+        static_assert(std::is_trivially_copyable<T>::value, "ring images are raw copies");
+        uint64_t header[2];
+        if (static_cast<size_t>(end - in) < sizeof(header)) return nullptr;
+        std::memcpy(header, in, sizeof(header));
+        in += sizeof(header);
+        size_t maxChunks = static_cast<size_t>(end - in) / sizeof(Chunk::items);
+        if (header[1] > maxChunks * CHUNK_ITEMS || ChunkWindow<Chunk>::chunksFor(header[0], header[1]) > maxChunks) {
+            return nullptr;
+        }
+        window.resetTo(header[0]);
+        window.extend(static_cast<size_t>(header[1]));
+        window.forEachChunk([&](Chunk* chunk) {
+            std::memcpy(static_cast<void*>(chunk->items), in, sizeof(chunk->items));
+            in += sizeof(chunk->items);
+        });
+        return in;
+    }
+
+private:
+    ChunkWindow<Chunk> window;
+};
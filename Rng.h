@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+// PCG32 (XSH-RR) generator. Small, fast and fully specified, so one seed
+// produces the same sequence on every compiler and platform, and each Game
+// can own its own stream instead of sharing the global rand() state.
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + INCREMENT;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+    }
+
+    // Uniform integer in [0, bound), without modulo bias
+    uint32_t nextBelow(uint32_t bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while (true) {
+            uint32_t r = next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+
+    // Uniform float in [0, 1) with 24 bits of precision
+    float nextFloat() {
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // True if both generators will produce the same sequence from here on
+    bool operator==(const Rng& other) const { return state == other.state; }
+
+private:
+    static constexpr uint64_t INCREMENT = 1442695040888963407ull;
+    uint64_t state = 0;
+};
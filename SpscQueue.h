@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Elements live in a fixed array and are never copied in or out: the
+// producer fills the slot from beginPush() and publishes it with push(), the
+// consumer reads front() in place and hands the slot back with pop().
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer: the free slot to fill, or nullptr if the queue is full
+    T* beginPush() {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == Capacity) return nullptr;
+        return &slots[tail & (Capacity - 1)];
+    }
+
+    // Producer: publishes the slot returned by beginPush()
+    void push() {
+        tailIndex.store(tailIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer: the oldest element, or nullptr if the queue is empty
+    T* front() {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return nullptr;
+        return &slots[head & (Capacity - 1)];
+    }
+
+    // Consumer: releases the slot returned by front() back to the producer
+    void pop() {
+        headIndex.store(headIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Only while neither thread is using the queue
+    void clear() {
+        headIndex.store(0, std::memory_order_relaxed);
+        tailIndex.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // Producer and consumer indices on separate cache lines so they do not false-share
+    alignas(64) std::atomic<size_t> headIndex{ 0 };
+    alignas(64) std::atomic<size_t> tailIndex{ 0 };
+    alignas(64) T slots[Capacity];
+};
@@ -0,0 +1,95 @@
+#include "ThreadPool.h"
+
+#include <exception>
+#include <iostream>
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        // Counters and deque change together, so a worker can never take a task before it is counted
+        std::lock_guard<std::mutex> lock(stateMutex);
+        WorkQueue& queue = *queues[nextQueue++ % queues.size()];
+        {
+            std::lock_guard<std::mutex> queueLock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        ++queued;
+        ++unfinished;
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return unfinished == 0; });
+}
+
+bool ThreadPool::popLocal(unsigned self, std::function<void()>& task) {
+    WorkQueue& queue = *queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(unsigned self, std::function<void()>& task) {
+    for (size_t i = 1; i < queues.size(); ++i) {
+        WorkQueue& victim = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned self) {
+    std::function<void()> task;
+    while (true) {
+        if (popLocal(self, task) || steal(self, task)) {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                --queued;
+            }
+            try {
+                task();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Error in thread pool task: " << e.what() << std::endl;
+            }
+            task = nullptr;
+
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--unfinished == 0) allDone.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads with one task deque per worker. A worker
+// takes tasks from the back of its own deque and, when that runs dry, steals
+// from the front of the others, so tasks of uneven length still keep every
+// core busy without a single shared queue becoming the bottleneck.
+class ThreadPool {
+public:
+    // threadCount = 0 uses one worker per hardware thread
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+    // Queues a task; tasks are dealt round-robin onto the workers' deques
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished
+    void wait();
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    size_t queued = 0;      // Tasks sitting in a deque (guarded by stateMutex)
+    size_t unfinished = 0;  // Tasks submitted but not yet completed (guarded by stateMutex)
+    size_t nextQueue = 0;
+    bool stopping = false;
+
+    bool popLocal(unsigned self, std::function<void()>& task);
+    bool steal(unsigned self, std::function<void()>& task);
+    void run(unsigned self);
+};
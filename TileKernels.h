@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CROSSY_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Per-frame platform decay: every tile behind the player (x < playerX or
+// z < playerZ) loses deltaTime of lifetime, clamped at zero. The kernels work
+// on contiguous x/z/lifetime arrays and all produce bit-identical results.
+using DecayKernel = void (*)(const int32_t* x, const int32_t* z, float* life, size_t count,
+    float playerX, float playerZ, float deltaTime);
+
+inline void decayLifetimesScalar(const int32_t* x, const int32_t* z, float* life, size_t count,
+    float playerX, float playerZ, float deltaTime) {
+    for (size_t i = 0; i < count; ++i) {
+        if (x[i] < playerX || z[i] < playerZ) {
+            life[i] -= deltaTime;
+        }
+        if (life[i] < 0.0f) life[i] = 0.0f;
+    }
+}
+
+#ifdef CROSSY_X86_SIMD
+__attribute__((target("sse2")))
+inline void decayLifetimesSSE2(const int32_t* x, const int32_t* z, float* life, size_t count,
+    float playerX, float playerZ, float deltaTime) {
+    const __m128 px = _mm_set1_ps(playerX);
+    const __m128 pz = _mm_set1_ps(playerZ);
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 fx = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        __m128 fz = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(z + i)));
+        __m128 behind = _mm_or_ps(_mm_cmplt_ps(fx, px), _mm_cmplt_ps(fz, pz));
+        __m128 l = _mm_loadu_ps(life + i);
+        l = _mm_sub_ps(l, _mm_and_ps(behind, dt));
+        _mm_storeu_ps(life + i, _mm_max_ps(l, zero));
+    }
+    decayLifetimesScalar(x + i, z + i, life + i, count - i, playerX, playerZ, deltaTime);
+}
+
+__attribute__((target("avx2")))
+inline void decayLifetimesAVX2(const int32_t* x, const int32_t* z, float* life, size_t count,
+    float playerX, float playerZ, float deltaTime) {
+    const __m256 px = _mm256_set1_ps(playerX);
+    const __m256 pz = _mm256_set1_ps(playerZ);
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 fx = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)));
+        __m256 fz = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(z + i)));
+        __m256 behind = _mm256_or_ps(_mm256_cmp_ps(fx, px, _CMP_LT_OQ), _mm256_cmp_ps(fz, pz, _CMP_LT_OQ));
+        __m256 l = _mm256_loadu_ps(life + i);
+        l = _mm256_sub_ps(l, _mm256_and_ps(behind, dt));
+        _mm256_storeu_ps(life + i, _mm256_max_ps(l, zero));
+    }
+    decayLifetimesSSE2(x + i, z + i, life + i, count - i, playerX, playerZ, deltaTime);
+}
+#endif
+
+// Picks the widest kernel the CPU supports, falling back to the scalar loop
+inline DecayKernel selectDecayKernel() {
+#ifdef CROSSY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return decayLifetimesAVX2;
+    if (__builtin_cpu_supports("sse2")) return decayLifetimesSSE2;
+#endif
+    return decayLifetimesScalar;
+}
+
+inline const char* decayKernelName(DecayKernel kernel) {
+#ifdef CROSSY_X86_SIMD
+    if (kernel == decayLifetimesAVX2) return "avx2";
+    if (kernel == decayLifetimesSSE2) return "sse2";
+#endif
+    return "scalar";
+}
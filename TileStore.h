@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ChunkPool.h"
+#include "TileKernels.h"
+
+// Path tiles stored as parallel x / z / lifetime / max-lifetime / corner arrays
+// in pooled 16-tile chunks, so the per-frame decay pass streams over contiguous
+// floats and the path never moves in memory when it grows. Same window
+// semantics as RingBuffer: tiles are appended at the back, retired from the
+// front, and keep an absolute sequence number; chunks behind the front go back
+// to the pool for the tiles ahead.
+class TileStore {
+public:
+    static constexpr size_t CHUNK_TILES = 16;
+
+    struct Chunk {
+        static constexpr size_t SLOTS = CHUNK_TILES;
+        alignas(32) int32_t xs[SLOTS];
+        alignas(32) int32_t zs[SLOTS];
+        alignas(32) float lifetimes[SLOTS];
+        float maxLifetimes[SLOTS];
+        uint8_t corners[SLOTS];
+        Chunk* nextFree;
+    };
+
+    explicit TileStore(size_t initialCapacity = 128) : window(initialCapacity) {}
+
+    size_t size() const { return window.size(); }
+    bool empty() const { return window.size() == 0; }
+    size_t capacity() const { return window.capacity(); }
+
+    uint64_t frontSeq() const { return window.frontSeq(); }
+    uint64_t endSeq() const { return window.endSeq(); }
+
+    void clear() { window.resetTo(0); }
+
+    void push_back(int x, int z, float lifetime, float maxLifetime, bool isCorner) {
+        uint64_t seq = window.push();
+        Chunk* chunk = window.chunkAt(seq);
+        size_t slot = window.slotOf(seq);
+        chunk->xs[slot] = x;
+        chunk->zs[slot] = z;
+        chunk->lifetimes[slot] = lifetime;
+        chunk->maxLifetimes[slot] = maxLifetime;
+        chunk->corners[slot] = isCorner ? 1 : 0;
+    }
+
+    void pop_front() { window.pop(); }
+
+    // Access by position in the window (0 = front)
+    int x(size_t i) const { return chunkOf(i)->xs[slotOf(i)]; }
+    int z(size_t i) const { return chunkOf(i)->zs[slotOf(i)]; }
+    float& lifetime(size_t i) { return chunkOf(i)->lifetimes[slotOf(i)]; }
+    float lifetime(size_t i) const { return chunkOf(i)->lifetimes[slotOf(i)]; }
+    float maxLifetime(size_t i) const { return chunkOf(i)->maxLifetimes[slotOf(i)]; }
+    bool isCorner(size_t i) const { return chunkOf(i)->corners[slotOf(i)] != 0; }
+
+    // Runs the decay kernel over every chunk holding live tiles. Whole chunks are
+    // decayed, so the kernel never runs a scalar tail; the slots outside the window
+    // are either retired or not written yet, and pushing a tile overwrites its slot.
+    void decay(DecayKernel kernel, float playerX, float playerZ, float deltaTime) {
+        window.forEachChunk([&](Chunk* chunk) {
+            kernel(chunk->xs, chunk->zs, chunk->lifetimes, CHUNK_TILES, playerX, playerZ, deltaTime);
+        });
+    }
+
+    // Image for snapshots: head and count, then the data of each chunk holding
+    // live tiles as it sits in memory. loadImage reuses the pooled chunks and
+    // returns nullptr if the image would run past end.
+    size_t imageBytes() const { return 2 * sizeof(uint64_t) + window.chunkCount() * CHUNK_BYTES; }
+
+    uint8_t* saveImage(uint8_t* out) const {
+        uint64_t header[2] = { frontSeq(), size() };
+        std::memcpy(out, header, sizeof(header));
+        out += sizeof(header);
+        window.forEachChunk([&](Chunk* chunk) {
+            std::memcpy(out, chunk, CHUNK_BYTES);
+            out += CHUNK_BYTES;
+        });
+        return out;
+    }
+
+    const uint8_t* loadImage(const uint8_t* in, const uint8_t* end) {
+        uint64_t header[2];
+        if (static_cast<size_t>(end - in) < sizeof(header)) return nullptr;
+        std::memcpy(header, in, sizeof(header));
+        in += sizeof(header);
+        size_t maxChunks = static_cast<size_t>(end - in) / CHUNK_BYTES;
+        if (header[1] > maxChunks * CHUNK_TILES || ChunkWindow<Chunk>::chunksFor(header[0], header[1]) > maxChunks) {
+            return nullptr;
+        }
+        window.resetTo(header[0]);
+        window.extend(static_cast<size_t>(header[1]));
+        window.forEachChunk([&](Chunk* chunk) {
+            std::memcpy(chunk, in, CHUNK_BYTES);
+            in += CHUNK_BYTES;
+        });
+        return in;
+    }
+
+private:
+    // Tile data of a chunk, without the free-list link
+    static constexpr size_t CHUNK_BYTES = offsetof(Chunk, nextFree);
+
+    ChunkWindow<Chunk> window;
+
+    Chunk* chunkOf(size_t i) const { return window.chunkAt(window.frontSeq() + i); }
+    size_t slotOf(size_t i) const { return window.slotOf(window.frontSeq() + i); }
+};
@@ -0,0 +1,96 @@
+// Micro-benchmark: posing obstacles one at a time with Game::obstaclePose over
+// the Obstacle array (the scalar reference, std::sin / std::cos) versus packed
+// per-type ObstacleBuckets and each set of pose kernels. Also reports each
+// kernel's largest deviation from the reference pose.
+//
+//   g++ -std=c++17 -O2 -pthread bench/obstacle_pose_bench.cpp libcrossy.a -o obstacle_pose_bench
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../Game.h"
+#include "../ObstacleKernels.h"
+
+template <typename Step>
+static double nsPerObstacle(size_t count, Step step) {
+    size_t rounds = std::max<size_t>(16, 100000000 / count);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r) step(r);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double(rounds) * count);
+}
+
+// Largest difference in any pose component; rotations compare modulo 360
+static float maxError(const std::vector<Game::Obstacle>& obstacles, const ObstacleBucket& bucket, double now) {
+    float worst = 0.0f;
+    for (size_t i = 0; i < obstacles.size(); ++i) {
+        Game::ObstaclePose p = Game::obstaclePose(obstacles[i], now);
+        float rotation = std::fabs(p.rotation - bucket.rotation[i]);
+        worst = std::max({ worst, std::fabs(p.height - bucket.height[i]), std::min(rotation, 360.0f - rotation),
+            std::fabs(p.offsetX - bucket.offsetX[i]), std::fabs(p.offsetZ - bucket.offsetZ[i]) });
+    }
+    return worst;
+}
+
+int main() {
+    const size_t sizes[] = { 128, 100000 };
+    const double now = 1000.0;  // Ages spread over [0, 1000) seconds
+
+    std::vector<const ObstacleKernelSet*> sets = { &OBSTACLE_KERNELS_SCALAR };
+#ifdef CROSSY_X86_SIMD
+    sets.push_back(&OBSTACLE_KERNELS_SSE2);
+    if (__builtin_cpu_supports("avx2")) sets.push_back(&OBSTACLE_KERNELS_AVX2);
+#endif
+
+    // The kernels see arguments up to 3 * age
+    float sinError = 0.0f, cosError = 0.0f;
+    for (int i = 0; i < 3000000; ++i) {
+        float x = static_cast<float>(i) * 0.001f, s, c;
+        fastSinCos(x, s, c);
+        sinError = std::max(sinError, std::fabs(s - std::sin(x)));
+        cosError = std::max(cosError, std::fabs(c - std::cos(x)));
+    }
+    std::printf("fastSinCos max error on [0, 3000): sin %.2e, cos %.2e\n", sinError, cosError);
+    std::printf("runtime kernels: %s\n", selectObstacleKernels().name);
+    std::printf("%10s %-10s %-12s %12s %12s\n", "obstacles", "type", "layout", "ns/obstacle", "max error");
+    for (size_t n : sizes) {
+        forEachObstacleType(ObstacleTypes(), [&](auto trait) {
+            using Trait = decltype(trait);
+            std::vector<Game::Obstacle> obstacles(n);
+            ObstacleBucket bucket;
+            for (size_t i = 0; i < n; ++i) {
+                Game::Obstacle& o = obstacles[i];
+                o.x = static_cast<int>(i);
+                o.z = static_cast<int>(i / 2);
+                o.type = static_cast<Game::ObstacleType>(Trait::TYPE);
+                o.active = true;
+                o.spawnTime = now * double(i) / double(n);
+                bucket.push_back(o.x, o.z, static_cast<float>(now - o.spawnTime));
+            }
+            bucket.preparePoses();
+
+            // The reference loop keeps a running sum so the poses are not optimized away
+            volatile float sink = 0.0f;
+            double scalarNs = nsPerObstacle(n, [&](size_t) {
+                float sum = 0.0f;
+                for (const Game::Obstacle& o : obstacles) {
+                    if (!o.active) continue;
+                    Game::ObstaclePose p = Game::obstaclePose(o, now);
+                    sum += p.height + p.rotation + p.offsetX + p.offsetZ;
+                }
+                sink = sink + sum;
+            });
+            std::printf("%10zu %-10s %-12s %12.3f %12s\n", n, Trait::NAME, "aos loop", scalarNs, "-");
+
+            for (const ObstacleKernelSet* set : sets) {
+                ObstacleKernel kernel = set->kernels[Trait::TYPE - 1];
+                double ns = nsPerObstacle(n, [&](size_t) { kernel(bucket, 0); });
+                std::printf("%10zu %-10s soa %-8s %12.3f %12.2e\n", n, Trait::NAME, set->name, ns,
+                    maxError(obstacles, bucket, now));
+            }
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Micro-benchmark: GameSnapshot capture and restore of a whole game with a
+// 1k / 100k tile path (platform lifetime raised so no tile ever retires).
+// Restores into a game of a different seed and checks the world hash, so a
+// restore that drops state fails loudly.
+//
+//   g++ -std=c++17 -O2 -pthread bench/snapshot_bench.cpp libcrossy.a -o snapshot_bench
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "../Game.h"
+#include "../GameSnapshot.h"
+
+template <typename Step>
+static double usPerCall(int calls, Step step) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) step();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / calls;
+}
+
+int main() {
+    const size_t sizes[] = { 1000, 100000 };
+
+    std::printf("%10s %12s %12s %12s\n", "tiles", "bytes", "capture us", "restore us");
+    for (size_t n : sizes) {
+        Game game;
+        game.tuning.platformLifetime = 1e9f;
+        game.reset(7);
+        while (game.path.size() < n) game.extendPath();
+        uint64_t hash = game.worldHash();
+
+        GameSnapshot snapshot;
+        Game other;
+        other.reset(8);
+        int calls = static_cast<int>(std::max<size_t>(20, 20000000 / n));
+
+        double capture = usPerCall(calls, [&] { snapshot.capture(game); });
+        double restore = usPerCall(calls, [&] { snapshot.restore(other); });
+        if (other.worldHash() != hash || other.score != game.score || other.seed != game.seed) {
+            std::printf("restored state differs at %zu tiles\n", n);
+            return 1;
+        }
+        std::printf("%10zu %12zu %12.2f %12.2f\n", game.path.size(), snapshot.size(), capture, restore);
+    }
+    return 0;
+}
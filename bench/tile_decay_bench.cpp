@@ -0,0 +1,75 @@
+// Micro-benchmark: per-frame platform decay over the old array of
+// (x, z, lifetime, max_lifetime, isCorner) tuples versus the TileStore
+// structure-of-arrays layout with each decay kernel.
+//
+//   g++ -std=c++17 -O2 -I.. tile_decay_bench.cpp -o tile_decay_bench
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
+#include "../TileStore.h"
+
+using Tile = std::tuple<int, int, float, float, bool>;
+
+static void decayTuples(std::vector<Tile>& path, float playerX, float playerZ, float deltaTime) {
+    for (auto& tile : path) {
+        int tileX = std::get<0>(tile);
+        int tileZ = std::get<1>(tile);
+        float& tileLife = std::get<2>(tile);
+
+        if (tileX < playerX || tileZ < playerZ) {
+            tileLife -= deltaTime;
+        }
+
+        if (tileLife < 0.0f) tileLife = 0.0f;
+    }
+}
+
+template <typename Step>
+static double nsPerTile(size_t tiles, Step step) {
+    size_t frames = std::max<size_t>(16, 200000000 / tiles);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < frames; ++f) step(f);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double(frames) * tiles);
+}
+
+int main() {
+    srand(12345);
+    const size_t sizes[] = { 1000, 100000, 1000000 };
+    const float dt = 0.016f;
+
+    struct Variant { const char* name; DecayKernel kernel; };
+    std::vector<Variant> variants = { { "soa scalar", decayLifetimesScalar } };
+#ifdef CROSSY_X86_SIMD
+    variants.push_back({ "soa sse2", decayLifetimesSSE2 });
+    if (__builtin_cpu_supports("avx2")) variants.push_back({ "soa avx2", decayLifetimesAVX2 });
+#endif
+
+    std::printf("runtime kernel: %s\n", decayKernelName(selectDecayKernel()));
+    std::printf("%10s %-12s %12s\n", "tiles", "layout", "ns/tile");
+    for (size_t n : sizes) {
+        std::vector<Tile> tuples;
+        TileStore store(n);
+        int x = 0, z = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (rand() % 2) x += 1; else z += 1;
+            // Lifetimes large enough that the clamp never hides the work
+            tuples.push_back(std::make_tuple(x, z, 1e9f, 1e9f, false));
+            store.push_back(x, z, 1e9f, 1e9f, false);
+        }
+        // Player in the middle of the path: half the tiles are behind
+        float px = float(std::get<0>(tuples[n / 2]));
+        float pz = float(std::get<1>(tuples[n / 2]));
+
+        std::printf("%10zu %-12s %12.3f\n", n, "aos tuple",
+            nsPerTile(n, [&](size_t) { decayTuples(tuples, px, pz, dt); }));
+        for (auto& v : variants) {
+            std::printf("%10zu %-12s %12.3f\n", n, v.name,
+                nsPerTile(n, [&](size_t) { store.decay(v.kernel, px, pz, dt); }));
+        }
+    }
+    return 0;
+}
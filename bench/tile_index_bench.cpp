@@ -0,0 +1,80 @@
+// Micro-benchmark: tile lookup cost as the path grows.
+// Compares the old linear scan over the path vector with the CellHash index.
+//
+//   g++ -std=c++17 -O2 -I.. tile_index_bench.cpp -o tile_index_bench
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <tuple>
+#include <vector>
+
+#include "../CellHash.h"
+
+using Tile = std::tuple<int, int, float, float, bool>;
+
+static void buildPath(size_t length, std::vector<Tile>& path, CellHash& index) {
+    path.clear();
+    index.clear();
+    int x = 0, z = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (rand() % 2) x += 1; else z += 1;
+        index.insert(x, z, static_cast<uint32_t>(path.size()));
+        path.push_back(std::make_tuple(x, z, 3.0f, 3.0f, (i % 7) == 0));
+    }
+}
+
+static bool linearLookup(const std::vector<Tile>& path, int x, int z) {
+    for (auto& tile : path) {
+        if (std::get<0>(tile) == x && std::get<1>(tile) == z && std::get<2>(tile) > 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hashedLookup(const std::vector<Tile>& path, const CellHash& index, int x, int z) {
+    uint32_t i = index.find(x, z);
+    return i != CellHash::NOT_FOUND && std::get<2>(path[i]) > 0.0f;
+}
+
+int main() {
+    srand(12345);
+    const size_t lengths[] = { 1000, 10000, 100000, 1000000 };
+
+    std::printf("%10s %16s %16s\n", "tiles", "linear ns/op", "hashed ns/op");
+    for (size_t length : lengths) {
+        std::vector<Tile> path;
+        CellHash index;
+        buildPath(length, path, index);
+
+        // Query the frontier, where the game actually looks up tiles
+        std::vector<std::pair<int, int>> queries;
+        for (int i = 0; i < 1024; ++i) {
+            const Tile& tile = path[path.size() - 1 - (rand() % 32)];
+            int dx = rand() % 3 - 1;
+            queries.push_back({ std::get<0>(tile) + dx, std::get<1>(tile) });
+        }
+
+        size_t linearOps = std::max<size_t>(64, 20000000 / length);
+        size_t hashedOps = 20000000;
+        volatile int sink = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < linearOps; ++i) {
+            auto& q = queries[i & 1023];
+            sink += linearLookup(path, q.first, q.second);
+        }
+        auto mid = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < hashedOps; ++i) {
+            auto& q = queries[i & 1023];
+            sink += hashedLookup(path, index, q.first, q.second);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double linearNs = std::chrono::duration<double, std::nano>(mid - start).count() / linearOps;
+        double hashedNs = std::chrono::duration<double, std::nano>(end - mid).count() / hashedOps;
+        std::printf("%10zu %16.1f %16.2f\n", length, linearNs, hashedNs);
+    }
+    return 0;
+}